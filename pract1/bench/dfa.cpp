@@ -0,0 +1,323 @@
+// Throughput benchmark for the table-driven lexer.
+//
+// Compares the DFA in lexer/dfa.hpp, which drives Lexer::lexToken(), with the
+// switch statement on the first character of a token that the lexer used
+// before. Both produce the same tokens, with interned identifiers and decoded
+// literals, so that only the dispatch differs. Use -verify to check that they
+// agree on the generated source.
+
+#include "generator.hpp"
+
+#include "lexer/identifiertable.hpp"
+#include "lexer/keywords.hpp"
+#include "lexer/lexer.hpp"
+#include "lexer/scanner.hpp"
+#include "lexer/tokenbuffer.hpp"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <optional>
+#include <string>
+#include <string_view>
+
+llvm::cl::opt<Mix> TokenMix(
+    "mix", llvm::cl::desc("Kind of source to generate"),
+    llvm::cl::values(
+        clEnumValN(Mix::Identifiers, "identifiers",
+                   "Declarations and expressions with many names"),
+        clEnumValN(Mix::Literals, "literals",
+                   "Integer, float and string literals"),
+        clEnumValN(Mix::Comments, "comments", "Mostly // comments"),
+        clEnumValN(Mix::Operators, "operators",
+                   "Dense operators without whitespace"),
+        clEnumValN(Mix::Mixed, "mixed", "All of the above, interleaved")),
+    llvm::cl::init(Mix::Mixed));
+
+llvm::cl::opt<double> SizeMB("size",
+                             llvm::cl::desc("Size of the source in MB"),
+                             llvm::cl::init(16));
+
+llvm::cl::opt<unsigned> Seed("seed",
+                             llvm::cl::desc("Seed for the generator"),
+                             llvm::cl::init(42));
+
+llvm::cl::opt<unsigned>
+    Repetitions("repeat",
+                llvm::cl::desc("Number of runs, of which the fastest counts"),
+                llvm::cl::init(5));
+
+llvm::cl::opt<bool>
+    Verify("verify",
+           llvm::cl::desc("Check that both lexers produce the same tokens"));
+
+// The lexer before the DFA: a switch on the first character of every token.
+// Errors are only counted, since the generated source has none.
+class SwitchLexer {
+  public:
+    SwitchLexer(std::string_view input)
+        : begin(input.data()), end(input.data()),
+          inputEnd(input.data() + input.size()) {}
+
+    std::optional<Token> next() {
+        while (end != inputEnd) {
+            begin = end;
+            if (std::optional<Token> token = lexToken())
+                return token;
+        }
+
+        return std::nullopt;
+    }
+
+    std::size_t getErrorCount() const { return errorCount; }
+
+  private:
+    const char *begin;
+    const char *end;
+    const char *inputEnd;
+
+    IdentifierTable identifiers;
+    std::size_t errorCount = 0;
+
+    std::optional<Token> lexToken() {
+        char c = *end++;
+
+        switch (c) {
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+            end = scanner::skip<scanner::Whitespace>(end, inputEnd);
+            return std::nullopt;
+        case ',':
+            return makeToken(TokenType::COMMA);
+        case ';':
+            return makeToken(TokenType::SEMICOLON);
+        case '(':
+            return makeToken(TokenType::LEFT_PAREN);
+        case ')':
+            return makeToken(TokenType::RIGHT_PAREN);
+        case '{':
+            return makeToken(TokenType::LEFT_BRACE);
+        case '}':
+            return makeToken(TokenType::RIGHT_BRACE);
+        case '[':
+            return makeToken(TokenType::LEFT_BRACKET);
+        case ']':
+            return makeToken(TokenType::RIGHT_BRACKET);
+        case '=':
+            return makeToken(match('=') ? TokenType::EQUALS_EQUALS
+                                        : TokenType::EQUALS);
+        case '<':
+            return makeToken(match('=') ? TokenType::LESS_THAN_EQUALS
+                                        : TokenType::LESS_THAN);
+        case '>':
+            return makeToken(match('=') ? TokenType::GREATER_THAN_EQUALS
+                                        : TokenType::GREATER_THAN);
+        case '+':
+            return makeToken(TokenType::PLUS);
+        case '-':
+            return makeToken(TokenType::MINUS);
+        case '*':
+            return makeToken(TokenType::STAR);
+        case '/':
+            if (match('/')) {
+                end = scanner::skip<scanner::LineBody>(end, inputEnd);
+                return std::nullopt;
+            }
+            return makeToken(TokenType::SLASH);
+        case '^':
+            return makeToken(TokenType::CARET);
+        case '%':
+            return makeToken(TokenType::PERCENT);
+        case '!':
+            if (match('='))
+                return makeToken(TokenType::BANG_EQUALS);
+            ++errorCount;
+            return std::nullopt;
+        case '"':
+            end = scanner::skip<scanner::StringBody>(end, inputEnd);
+            if (!match('"')) {
+                ++errorCount;
+                return std::nullopt;
+            }
+            return makeToken(TokenType::STRING_LITERAL);
+        default:
+            if (scanner::isDigit(c))
+                return makeNumber();
+            if (scanner::isIdentifierStart(c)) {
+                end = scanner::skip<scanner::IdentifierChars>(end, inputEnd);
+                return makeIdentifier();
+            }
+            ++errorCount;
+            return std::nullopt;
+        }
+    }
+
+    // Adds the next character to the token if it is c.
+    bool match(char c) {
+        if (end == inputEnd || *end != c)
+            return false;
+
+        ++end;
+        return true;
+    }
+
+    std::string_view getLexeme() const {
+        return std::string_view{begin, static_cast<std::size_t>(end - begin)};
+    }
+
+    Token makeToken(TokenType type) const { return Token(type, getLexeme()); }
+
+    Token makeIdentifier() {
+        std::string_view lexeme = getLexeme();
+        TokenType type = keywords::classify(lexeme);
+
+        if (type != TokenType::IDENTIFIER)
+            return makeToken(type);
+
+        return Token(type, lexeme, identifiers.get(lexeme));
+    }
+
+    Token makeNumber() {
+        end = scanner::skip<scanner::Digits>(end, inputEnd);
+
+        if (!match('.')) {
+            Token token = makeToken(TokenType::INT_LITERAL);
+            token.intValue = 0;
+            if (std::from_chars(begin, end, token.intValue).ec ==
+                std::errc::result_out_of_range)
+                ++errorCount;
+            return token;
+        }
+
+        while (true) {
+            end = scanner::skip<scanner::Digits>(end, inputEnd);
+            if (!match('.'))
+                break;
+            ++errorCount;
+        }
+
+        Token token = makeToken(TokenType::FLOAT_LITERAL);
+        token.floatValue = 0;
+        if (std::from_chars(begin, end, token.floatValue,
+                            std::chars_format::fixed)
+                .ec == std::errc::result_out_of_range)
+            ++errorCount;
+        return token;
+    }
+};
+
+template <typename LexerType> static TokenBuffer lex(std::string_view input) {
+    LexerType lexer{input};
+    TokenBuffer tokens{input};
+
+    while (std::optional<Token> token = lexer.next())
+        tokens.push_back(*token);
+
+    return tokens;
+}
+
+// Returns the index of the first token that differs, or the number of tokens
+// if there is none.
+static std::size_t findMismatch(const TokenBuffer &a, const TokenBuffer &b) {
+    std::size_t i = 0;
+
+    for (; i < a.size() && i < b.size(); ++i) {
+        if (a.getType(i) != b.getType(i) || a.getOffset(i) != b.getOffset(i) ||
+            a.getLength(i) != b.getLength(i) || a.getData(i) != b.getData(i))
+            break;
+    }
+
+    return i;
+}
+
+// Returns the fastest time in seconds of Repetitions runs of lex, which
+// returns the number of tokens.
+template <typename Fn>
+static double measure(Fn lex, std::size_t &tokenCount) {
+    double best = 0;
+
+    for (unsigned i = 0; i < Repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        tokenCount = lex();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        if (i == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+
+    return best;
+}
+
+static void report(const char *name, std::size_t bytes, std::size_t tokenCount,
+                   double seconds) {
+    fmt::print("{:20}{:10.1f} MB/s{:10.1f} Mtokens/s{:10.2f} ns/token\n", name,
+               bytes / seconds / 1e6, tokenCount / seconds / 1e6,
+               tokenCount ? seconds * 1e9 / tokenCount : 0.0);
+}
+
+int main(int argc, char *argv[]) {
+    llvm::cl::ParseCommandLineOptions(argc, argv);
+
+    auto size = static_cast<std::size_t>(SizeMB * 1e6);
+
+    std::string input;
+    input.reserve(size + 1024);
+
+    Generator generator{Seed};
+    while (input.size() < size)
+        generator.appendLine(input, TokenMix);
+
+    if (Verify) {
+        TokenBuffer expected = lex<SwitchLexer>(input);
+        TokenBuffer actual = lex<Lexer>(input);
+
+        std::size_t mismatch = findMismatch(expected, actual);
+        if (mismatch != expected.size() || mismatch != actual.size()) {
+            llvm::WithColor::error(llvm::errs(), "microcc-dfa-bench")
+                << fmt::format("the lexers differ at token {}\n", mismatch);
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::size_t tokenCount = 0;
+
+    double seconds = measure(
+        [&input] {
+            SwitchLexer lexer{input};
+            std::size_t count = 0;
+            while (lexer.next())
+                ++count;
+            return count;
+        },
+        tokenCount);
+    report("switch", input.size(), tokenCount, seconds);
+
+    seconds = measure(
+        [&input] {
+            Lexer lexer{input};
+            std::size_t count = 0;
+            while (lexer.next())
+                ++count;
+            return count;
+        },
+        tokenCount);
+    report("DFA", input.size(), tokenCount, seconds);
+
+    seconds = measure([&input] { return lex<SwitchLexer>(input).size(); },
+                      tokenCount);
+    report("switch, TokenBuffer", input.size(), tokenCount, seconds);
+
+    seconds = measure([&input] { return lex<Lexer>(input).size(); },
+                      tokenCount);
+    report("DFA, TokenBuffer", input.size(), tokenCount, seconds);
+
+    return EXIT_SUCCESS;
+}
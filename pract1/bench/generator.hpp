@@ -0,0 +1,120 @@
+#ifndef BENCH_GENERATOR_HPP
+#define BENCH_GENERATOR_HPP
+
+#include <cstddef>
+#include <fmt/core.h>
+#include <random>
+#include <string>
+
+// Kinds of synthetic MicroC source that the benchmarks lex.
+enum class Mix { Identifiers, Literals, Comments, Operators, Mixed };
+
+// Generates MicroC source code, one line at a time.
+class Generator {
+  public:
+    Generator(unsigned seed) : rng(seed) {}
+
+    void appendLine(std::string &out, Mix mix) {
+        switch (mix) {
+        case Mix::Identifiers:
+            appendDeclaration(out);
+            break;
+        case Mix::Literals:
+            appendLiterals(out);
+            break;
+        case Mix::Comments:
+            appendComment(out);
+            break;
+        case Mix::Operators:
+            appendOperators(out);
+            break;
+        case Mix::Mixed:
+            appendLine(out, static_cast<Mix>(pick(4)));
+            break;
+        }
+    }
+
+  private:
+    std::mt19937 rng;
+
+    std::size_t pick(std::size_t n) {
+        return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng);
+    }
+
+    template <std::size_t N> const char *pick(const char *const (&list)[N]) {
+        return list[pick(N)];
+    }
+
+    void appendIdentifier(std::string &out) {
+        static const char *const names[] = {
+            "i",     "j",      "x",      "y",      "count", "index",
+            "value", "result", "buffer", "length", "sum",   "average",
+            "whilst", "iff",   "returns", "format"};
+
+        out += pick(names);
+        if (pick(2))
+            out += fmt::format("_{}", pick(1000));
+    }
+
+    void appendDeclaration(std::string &out) {
+        out += pick(2) ? "int " : "float ";
+        appendIdentifier(out);
+        out += " = ";
+        appendIdentifier(out);
+
+        for (std::size_t i = pick(4); i > 0; --i) {
+            out += pick(2) ? " + " : " * ";
+            appendIdentifier(out);
+            if (pick(4) == 0) {
+                out += '[';
+                appendIdentifier(out);
+                out += ']';
+            }
+        }
+
+        out += ";\n";
+    }
+
+    void appendLiterals(std::string &out) {
+        appendIdentifier(out);
+        out += fmt::format(" = {} + {}.{} * {};", pick(100000), pick(1000),
+                           pick(100000), pick(10));
+
+        if (pick(2))
+            out += fmt::format(" print(\"literal number {} in a string\");",
+                               pick(1000));
+
+        out += '\n';
+    }
+
+    void appendComment(std::string &out) {
+        static const char *const words[] = {"the",   "lexer", "skips",
+                                            "these", "lines", "quickly",
+                                            "//",    "\"",    "return"};
+
+        out += "//";
+        for (std::size_t i = 3 + pick(10); i > 0; --i) {
+            out += ' ';
+            out += pick(words);
+        }
+        out += '\n';
+
+        if (pick(4) == 0)
+            appendDeclaration(out);
+    }
+
+    void appendOperators(std::string &out) {
+        static const char *const operators[] = {
+            "==", "!=", "<=", ">=", "<", ">", "+", "-",
+            "*",  "/",  "^",  "%",  "=", "(", ")", ","};
+
+        out += pick(26) + 'a';
+        for (std::size_t i = 8 + pick(8); i > 0; --i) {
+            out += pick(operators);
+            out += pick(26) + 'a';
+        }
+        out += ";\n";
+    }
+};
+
+#endif /* end of include guard: BENCH_GENERATOR_HPP */
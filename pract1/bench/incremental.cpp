@@ -0,0 +1,132 @@
+// Latency benchmark for incremental re-lexing.
+//
+// Applies random small edits (insertions, deletions and replacements of a few
+// characters) to the input with an IncrementalLexer, and compares the time per
+// edit with lexing the whole text again. With -verify, the tokens and errors
+// after every edit are checked against those of a fresh lexer.
+
+#include "lexer/incrementallexer.hpp"
+#include "lexer/tokenbuffer.hpp"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <random>
+#include <string>
+#include <string_view>
+
+llvm::cl::opt<std::string> InputFilename(llvm::cl::Positional,
+                                         llvm::cl::desc("<input file>"),
+                                         llvm::cl::Required);
+
+llvm::cl::opt<unsigned> NumEdits("n", llvm::cl::desc("Number of edits"),
+                                 llvm::cl::init(1000));
+
+llvm::cl::opt<bool>
+    Verify("verify",
+           llvm::cl::desc("Compare the result of every edit with a full lex"));
+
+// Snippets that are inserted, chosen to also split and join tokens, and to
+// open and close comments and string literals.
+static const char *const snippets[] = {
+    "x", "1", "1.5", " ", "\n", "=", "==", "!", "//", "\"", ";", "foo",
+    "while", "(", ")", "{", "}", "@",
+};
+
+static bool equal(const IncrementalLexer &lexer, const IncrementalLexer &fresh) {
+    const TokenBuffer &a = lexer.getTokens();
+    const TokenBuffer &b = fresh.getTokens();
+
+    if (a.size() != b.size())
+        return false;
+
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a.getType(i) != b.getType(i) || a.getOffset(i) != b.getOffset(i) ||
+            a.getLength(i) != b.getLength(i))
+            return false;
+
+        Token x = a[i];
+        Token y = b[i];
+
+        if ((x.type == TokenType::INT_LITERAL && x.intValue != y.intValue) ||
+            (x.type == TokenType::FLOAT_LITERAL &&
+             x.floatValue != y.floatValue))
+            return false;
+    }
+
+    if (lexer.getErrors().size() != fresh.getErrors().size())
+        return false;
+
+    for (std::size_t i = 0; i < lexer.getErrors().size(); ++i) {
+        const IncrementalLexer::Error &x = lexer.getErrors()[i];
+        const IncrementalLexer::Error &y = fresh.getErrors()[i];
+
+        if (x.runBegin != y.runBegin || x.position != y.position ||
+            x.message != y.message)
+            return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    llvm::cl::ParseCommandLineOptions(argc, argv);
+
+    auto inputBuffer = llvm::MemoryBuffer::getFile(InputFilename);
+    if (!inputBuffer) {
+        llvm::WithColor::error(llvm::errs(), "microcc-incremental-lexer-bench")
+            << fmt::format("{}: {}\n", InputFilename.getValue(),
+                           inputBuffer.getError().message());
+        return EXIT_FAILURE;
+    }
+
+    std::string input{(*inputBuffer)->getBuffer()};
+
+    auto start = std::chrono::steady_clock::now();
+    IncrementalLexer lexer{input};
+    std::chrono::duration<double> full =
+        std::chrono::steady_clock::now() - start;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<std::size_t> pickSnippet(
+        0, std::size(snippets) - 1);
+    std::uniform_int_distribution<std::uint32_t> pickRemoved(0, 3);
+
+    std::chrono::duration<double> total{0};
+    std::size_t relexed = 0;
+
+    for (unsigned i = 0; i < NumEdits; ++i) {
+        std::uint32_t size = static_cast<std::uint32_t>(lexer.getText().size());
+        std::uint32_t offset =
+            std::uniform_int_distribution<std::uint32_t>(0, size)(rng);
+        std::uint32_t removed = std::min(pickRemoved(rng), size - offset);
+        std::string_view inserted = i % 3 == 0 ? "" : snippets[pickSnippet(rng)];
+
+        start = std::chrono::steady_clock::now();
+        lexer.edit(offset, removed, inserted);
+        total += std::chrono::steady_clock::now() - start;
+
+        relexed += lexer.getRelexedCount();
+
+        if (Verify && !equal(lexer, IncrementalLexer{std::string{lexer.getText()}})) {
+            llvm::WithColor::error(llvm::errs(), "microcc-incremental-lexer-bench")
+                << fmt::format("mismatch after edit {} (offset {}, removed {}, "
+                               "inserted '{}')\n",
+                               i, offset, removed, inserted);
+            return EXIT_FAILURE;
+        }
+    }
+
+    fmt::print("full lex            {:10.3f} ms  ({} tokens)\n",
+               full.count() * 1e3, lexer.getTokens().size());
+    fmt::print("incremental edit    {:10.3f} ms  ({:.1f} tokens lexed)\n",
+               total.count() * 1e3 / NumEdits,
+               static_cast<double>(relexed) / NumEdits);
+
+    return EXIT_SUCCESS;
+}
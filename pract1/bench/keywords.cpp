@@ -0,0 +1,90 @@
+// Microbenchmark for keyword recognition on identifier-heavy input.
+//
+// Compares the compile-time perfect hash in lexer/keywords.hpp with the chain
+// of string comparisons that the lexer used before.
+
+#include "lexer/keywords.hpp"
+#include "lexer/token.hpp"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+llvm::cl::opt<unsigned>
+    NumIdentifiers("n", llvm::cl::desc("Number of identifiers to classify"),
+                   llvm::cl::init(10000000));
+
+llvm::cl::opt<unsigned>
+    KeywordPercentage("keywords",
+                      llvm::cl::desc("Percentage of identifiers that are "
+                                     "keywords"),
+                      llvm::cl::init(20));
+
+static TokenType classifyWithComparisons(std::string_view identifier) {
+    if (identifier == "return")
+        return TokenType::RETURN;
+    if (identifier == "if")
+        return TokenType::IF;
+    if (identifier == "else")
+        return TokenType::ELSE;
+    if (identifier == "while")
+        return TokenType::WHILE;
+    if (identifier == "for")
+        return TokenType::FOR;
+
+    return TokenType::IDENTIFIER;
+}
+
+// Typical identifiers, some of which share a prefix or length with a keyword.
+static const char *const identifiers[] = {
+    "i",     "x",      "int",     "float", "counter", "iff",   "elsewhere",
+    "whilst", "format", "returns", "foo",  "bar_baz", "index", "value",
+};
+
+template <typename Fn>
+static void run(const char *name, const std::vector<std::string_view> &input,
+                Fn classify) {
+    auto start = std::chrono::steady_clock::now();
+
+    unsigned keywordCount = 0;
+    for (std::string_view identifier : input)
+        keywordCount += classify(identifier) != TokenType::IDENTIFIER;
+
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    fmt::print("{:24}{:10.2f} ns/identifier  ({} keywords)\n", name,
+               elapsed.count() * 1e9 / input.size(), keywordCount);
+}
+
+int main(int argc, char *argv[]) {
+    llvm::cl::ParseCommandLineOptions(argc, argv);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> percent(0, 99);
+    std::uniform_int_distribution<std::size_t> pickKeyword(
+        0, keywords::list.size() - 1);
+    std::uniform_int_distribution<std::size_t> pickIdentifier(
+        0, std::size(identifiers) - 1);
+
+    std::vector<std::string_view> input;
+    input.reserve(NumIdentifiers);
+
+    for (unsigned i = 0; i < NumIdentifiers; ++i) {
+        if (percent(rng) < KeywordPercentage)
+            input.push_back(keywords::list[pickKeyword(rng)].spelling);
+        else
+            input.push_back(identifiers[pickIdentifier(rng)]);
+    }
+
+    run("string comparisons", input, classifyWithComparisons);
+    run("perfect hash", input, keywords::classify);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,136 @@
+// Throughput benchmark for the lexer on synthetic MicroC sources.
+//
+// Generates a source of the requested size with one of several token mixes,
+// lexes it with the Lexer, and reports MB/s, tokens/s and heap allocations per
+// token, both for streaming tokens with Lexer::next() and for collecting them
+// in a TokenBuffer. Use -dump to write the generated source to stdout instead.
+
+#include "generator.hpp"
+
+#include "lexer/lexer.hpp"
+#include "lexer/tokenbuffer.hpp"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <new>
+#include <optional>
+#include <string>
+
+// Count every heap allocation, so we can report allocations per token.
+static std::size_t allocationCount = 0;
+
+void *operator new(std::size_t size) {
+    ++allocationCount;
+
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+llvm::cl::opt<Mix> TokenMix(
+    "mix", llvm::cl::desc("Kind of source to generate"),
+    llvm::cl::values(
+        clEnumValN(Mix::Identifiers, "identifiers",
+                   "Declarations and expressions with many names"),
+        clEnumValN(Mix::Literals, "literals",
+                   "Integer, float and string literals"),
+        clEnumValN(Mix::Comments, "comments", "Mostly // comments"),
+        clEnumValN(Mix::Operators, "operators",
+                   "Dense operators without whitespace"),
+        clEnumValN(Mix::Mixed, "mixed", "All of the above, interleaved")),
+    llvm::cl::init(Mix::Mixed));
+
+llvm::cl::opt<double> SizeMB("size",
+                             llvm::cl::desc("Size of the source in MB"),
+                             llvm::cl::init(16));
+
+llvm::cl::opt<unsigned> Seed("seed",
+                             llvm::cl::desc("Seed for the generator"),
+                             llvm::cl::init(42));
+
+llvm::cl::opt<unsigned>
+    Repetitions("repeat",
+                llvm::cl::desc("Number of runs, of which the fastest counts"),
+                llvm::cl::init(3));
+
+llvm::cl::opt<bool>
+    Dump("dump", llvm::cl::desc("Print the generated source and exit"));
+
+// Returns the fastest time in seconds of Repetitions runs of lex, which
+// returns the number of tokens, and the allocations of that run.
+template <typename Fn>
+static double measure(Fn lex, std::size_t &tokenCount,
+                      std::size_t &allocations) {
+    double best = 0;
+
+    for (unsigned i = 0; i < Repetitions; ++i) {
+        std::size_t allocationsBefore = allocationCount;
+        auto start = std::chrono::steady_clock::now();
+        tokenCount = lex();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        allocations = allocationCount - allocationsBefore;
+
+        if (i == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+
+    return best;
+}
+
+static void report(const char *name, std::size_t bytes, std::size_t tokenCount,
+                   std::size_t allocations, double seconds) {
+    fmt::print("{:20}{:10.1f} MB/s{:10.1f} Mtokens/s{:10.4f} allocations/token\n",
+               name, bytes / seconds / 1e6, tokenCount / seconds / 1e6,
+               tokenCount ? static_cast<double>(allocations) / tokenCount : 0.0);
+}
+
+int main(int argc, char *argv[]) {
+    llvm::cl::ParseCommandLineOptions(argc, argv);
+
+    auto size = static_cast<std::size_t>(SizeMB * 1e6);
+
+    std::string input;
+    input.reserve(size + 1024);
+
+    Generator generator{Seed};
+    while (input.size() < size)
+        generator.appendLine(input, TokenMix);
+
+    if (Dump) {
+        fmt::print("{}", input);
+        return EXIT_SUCCESS;
+    }
+
+    std::size_t tokenCount = 0;
+    std::size_t allocations = 0;
+
+    double seconds = measure(
+        [&input] {
+            Lexer lexer{input};
+            std::size_t count = 0;
+            while (lexer.next())
+                ++count;
+            return count;
+        },
+        tokenCount, allocations);
+    report("Lexer::next()", input.size(), tokenCount, allocations, seconds);
+
+    seconds = measure(
+        [&input] { return Lexer{input}.getTokenBuffer().size(); }, tokenCount,
+        allocations);
+    report("TokenBuffer", input.size(), tokenCount, allocations, seconds);
+
+    return EXIT_SUCCESS;
+}
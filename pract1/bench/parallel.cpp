@@ -0,0 +1,109 @@
+// Scaling benchmark for the parallel lexer.
+//
+// Lexes the input once with the sequential Lexer and then with the
+// ParallelLexer on 1, 2, 4, ... threads, up to the number of hardware threads,
+// and reports the throughput and the speedup over the sequential lexer.
+
+#include "lexer/lexer.hpp"
+#include "lexer/parallellexer.hpp"
+#include "lexer/tokenbuffer.hpp"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <string>
+#include <string_view>
+
+llvm::cl::opt<std::string> InputFilename(llvm::cl::Positional,
+                                         llvm::cl::desc("<input file>"),
+                                         llvm::cl::Required);
+
+llvm::cl::opt<unsigned> MaxThreads(
+    "max-threads",
+    llvm::cl::desc("Maximum number of threads (0 = one per hardware thread)"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<std::size_t>
+    ChunkSize("chunk-size",
+              llvm::cl::desc("Size in bytes of the chunks that are lexed in "
+                             "parallel"),
+              llvm::cl::init(ParallelLexer::defaultChunkSize));
+
+llvm::cl::opt<unsigned>
+    Repetitions("repeat",
+                llvm::cl::desc("Number of runs, of which the fastest counts"),
+                llvm::cl::init(3));
+
+// Returns the fastest time in seconds of Repetitions runs of lex, which
+// returns the number of tokens.
+template <typename Fn>
+static double measure(Fn lex, std::size_t &tokenCount) {
+    double best = 0;
+
+    for (unsigned i = 0; i < Repetitions; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        tokenCount = lex();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        if (i == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+
+    return best;
+}
+
+static void report(const std::string &name, std::size_t bytes,
+                   std::size_t tokenCount, double seconds, double baseline) {
+    fmt::print("{:20}{:10.1f} MB/s{:12.1f} Mtokens/s{:8.2f}x\n", name,
+               bytes / seconds / 1e6, tokenCount / seconds / 1e6,
+               baseline / seconds);
+}
+
+int main(int argc, char *argv[]) {
+    llvm::cl::ParseCommandLineOptions(argc, argv);
+
+    auto inputBuffer = llvm::MemoryBuffer::getFile(InputFilename);
+    if (!inputBuffer) {
+        llvm::WithColor::error(llvm::errs(), "microcc-parallel-lexer-bench")
+            << fmt::format("{}: {}\n", InputFilename.getValue(),
+                           inputBuffer.getError().message());
+        return EXIT_FAILURE;
+    }
+
+    std::string_view input = (*inputBuffer)->getBuffer();
+
+    unsigned maxThreads = MaxThreads;
+    if (maxThreads == 0)
+        maxThreads = llvm::hardware_concurrency().compute_thread_count();
+
+    std::size_t tokenCount = 0;
+
+    double baseline = measure(
+        [input] { return Lexer{input}.getTokenBuffer().size(); }, tokenCount);
+    report("sequential", input.size(), tokenCount, baseline, baseline);
+
+    for (unsigned threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        double seconds = measure(
+            [input, threads] {
+                return ParallelLexer{input, threads, ChunkSize}
+                    .getTokenBuffer()
+                    .size();
+            },
+            tokenCount);
+        report(fmt::format("{} thread(s)", threads), input.size(), tokenCount,
+               seconds, baseline);
+
+        if (threads >= maxThreads)
+            break;
+    }
+
+    return EXIT_SUCCESS;
+}
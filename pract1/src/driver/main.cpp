@@ -1,51 +1,182 @@
+#include "lexer/compression.hpp"
+#include "lexer/diagnosticengine.hpp"
 #include "lexer/lexer.hpp"
+#include "lexer/parallellexer.hpp"
+#include "lexer/sourcemanager.hpp"
 #include "lexer/token.hpp"
+#include "lexer/tokendumper.hpp"
+#include "lexer/tokenfile.hpp"
 
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
 
+#include <cstddef>
 #include <cstdlib>
 #include <fmt/core.h>
-#include <fstream>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
-#include <streambuf>
+#include <memory>
+#include <optional>
 #include <string>
-#include <vector>
+#include <string_view>
+#include <system_error>
+#include <utility>
 
 llvm::cl::opt<std::string> InputFilename(llvm::cl::Positional,
                                          llvm::cl::desc("<input file>"),
                                          llvm::cl::init("-"));
 
+llvm::cl::opt<std::string> EmitTokens(
+    "emit-tokens",
+    llvm::cl::desc("Write the tokens to <file> in the binary .mctok format, "
+                   "instead of printing them"),
+    llvm::cl::value_desc("file"));
+
+llvm::cl::opt<unsigned>
+    ErrorLimit("ferror-limit",
+               llvm::cl::desc("Stop after this many errors (0 = no limit)"),
+               llvm::cl::init(0));
+
+llvm::cl::opt<unsigned>
+    Threads("j",
+            llvm::cl::desc("Number of threads to lex with (0 = one per "
+                           "hardware thread)"),
+            llvm::cl::init(1));
+
+llvm::cl::opt<std::size_t> ChunkSize(
+    "lex-chunk-size",
+    llvm::cl::desc("Size in bytes of the chunks that are lexed in parallel"),
+    llvm::cl::init(ParallelLexer::defaultChunkSize), llvm::cl::Hidden);
+
+// Writes the tokens of a source without errors to the file given by
+// -emit-tokens. Returns false if the file cannot be written.
+static bool writeTokenFile(const TokenBuffer &tokens,
+                           const IdentifierTable &identifiers) {
+    std::error_code error;
+    llvm::raw_fd_ostream out(EmitTokens, error);
+
+    if (!error) {
+        TokenFile::write(out, tokens, identifiers);
+        out.close();
+        error = out.error();
+    }
+
+    if (error) {
+        llvm::WithColor::error(llvm::errs(), "microcc")
+            << fmt::format("{}: {}\n", EmitTokens.getValue(), error.message());
+        return false;
+    }
+
+    return true;
+}
+
+// Prints the tokens of a token file.
+static int dumpTokenFile(std::string_view buffer) {
+    llvm::Expected<TokenFile> file = TokenFile::read(buffer);
+    if (!file) {
+        llvm::WithColor::error(llvm::errs(), "microcc")
+            << fmt::format("{}: {}\n", InputFilename.getValue(),
+                           llvm::toString(file.takeError()));
+        return EXIT_FAILURE;
+    }
+
+    SourceManager sourceManager{file->getSource()};
+
+    TokenDumper dumper{sourceManager};
+    while (std::optional<Token> token = file->next())
+        dumper.dump(*token);
+
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char *argv[]) {
     // Parse command-line arguments
     llvm::cl::ParseCommandLineOptions(argc, argv);
 
-    // Convert input file/stdin to string
-    std::string inputContents;
-    if (InputFilename == "-") {
-        inputContents = std::string{std::istreambuf_iterator<char>(std::cin),
-                                    std::istreambuf_iterator<char>()};
-    } else {
-        std::ifstream inputFile{InputFilename};
-        inputContents = std::string{std::istreambuf_iterator<char>(inputFile),
-                                    std::istreambuf_iterator<char>()};
+    // Map the input file into memory, or read it if it is stdin or a pipe.
+    // The lexer borrows this buffer, so it must stay alive until we are done.
+    auto inputBuffer = llvm::MemoryBuffer::getFileOrSTDIN(InputFilename);
+    if (!inputBuffer) {
+        llvm::WithColor::error(llvm::errs(), "microcc")
+            << fmt::format("{}: {}\n", InputFilename.getValue(),
+                           inputBuffer.getError().message());
+        return EXIT_FAILURE;
+    }
+
+    // Decompress gzip or zstd input in memory.
+    llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> decompressed =
+        compression::decompress(std::move(*inputBuffer));
+    if (!decompressed) {
+        llvm::WithColor::error(llvm::errs(), "microcc")
+            << fmt::format("{}: {}\n", InputFilename.getValue(),
+                           llvm::toString(decompressed.takeError()));
+        return EXIT_FAILURE;
+    }
+
+    llvm::StringRef input = (*decompressed)->getBuffer();
+
+    // The tokens of a token file are printed like those of a source file.
+    if (TokenFile::isTokenFile(input))
+        return dumpTokenFile(input);
+
+    // Tokens refer to the source by 32-bit offsets.
+    if (input.size() > SourceManager::maxBufferSize) {
+        llvm::WithColor::error(llvm::errs(), "microcc") << fmt::format(
+            "{}: input is too large ({} bytes, at most {})\n",
+            InputFilename.getValue(), input.size(),
+            SourceManager::maxBufferSize);
+        return EXIT_FAILURE;
     }
 
+    // Errors are buffered, and printed at the end.
+    DiagnosticEngine diagnostics{ErrorLimit};
+
     // Phase 1: lexical analysis
-    Lexer lexer{inputContents};
-    std::vector<Token> tokens = lexer.getTokens();
+    if (Threads != 1) {
+        ParallelLexer lexer{input, diagnostics, Threads, ChunkSize};
+        TokenBuffer tokens = lexer.getTokenBuffer();
+
+        if (EmitTokens.empty()) {
+            TokenDumper dumper{lexer.getSourceManager()};
+            for (std::size_t i = 0; i < tokens.size(); ++i)
+                dumper.dump(tokens[i]);
+            dumper.flush();
+        }
 
-    for (const Token &token : tokens) {
-        std::string location =
-            fmt::format("{}:{} -> {}:{}", token.begin.line, token.begin.col,
-                        token.end.line, token.end.col);
+        diagnostics.flush(lexer.getSourceManager());
 
-        fmt::print("{:20}{:20}{:20}\n", location, token.lexeme,
-                   token_type_to_string(token.type));
+        if (diagnostics.hadError())
+            return EXIT_FAILURE;
+
+        if (!EmitTokens.empty() &&
+            !writeTokenFile(tokens, lexer.getIdentifierTable()))
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
+    }
+
+    Lexer lexer{input, diagnostics};
+
+    if (!EmitTokens.empty()) {
+        TokenBuffer tokens = lexer.getTokenBuffer();
+
+        diagnostics.flush(lexer.getSourceManager());
+
+        if (diagnostics.hadError() ||
+            !writeTokenFile(tokens, lexer.getIdentifierTable()))
+            return EXIT_FAILURE;
+
+        return EXIT_SUCCESS;
     }
 
-    if (lexer.hadError())
+    TokenDumper dumper{lexer.getSourceManager()};
+    while (std::optional<Token> token = lexer.next())
+        dumper.dump(*token);
+    dumper.flush();
+
+    diagnostics.flush(lexer.getSourceManager());
+
+    if (diagnostics.hadError())
         return EXIT_FAILURE;
 
     return EXIT_SUCCESS;
@@ -0,0 +1,317 @@
+#ifndef DFA_HPP
+#define DFA_HPP
+
+// Tables for the deterministic finite automaton that drives the lexer. All
+// tables are generated at compile time.
+//
+// The lexer starts every token in State::Start, and keeps following the
+// transition for the class of the next character until the transition says
+// State::Stop. The state it stops in then decides which token (if any) is
+// emitted, or which error is reported.
+
+#include "lexer/token.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace dfa {
+
+enum class CharClass : std::uint8_t {
+    Other, // Any character that cannot start a token.
+    Whitespace,
+    Newline,
+    Digit,
+    IdentifierStart,
+    Dot,
+    Quote,
+    Slash,
+    Equals,
+    Bang,
+    Less,
+    Greater,
+    Plus,
+    Minus,
+    Star,
+    Caret,
+    Percent,
+    LeftParen,
+    RightParen,
+    LeftBrace,
+    RightBrace,
+    LeftBracket,
+    RightBracket,
+    Comma,
+    Semicolon,
+    EndOfInput, // Not in the character table; used when the input runs out.
+
+    NumClasses
+};
+
+enum class State : std::uint8_t {
+    Start,
+    Whitespace,
+    Identifier,
+    Integer,
+    Float,
+    Slash,
+    Comment,
+    String,
+    StringEnd,
+    Equals,
+    EqualsEquals,
+    Bang,
+    BangEquals,
+    Less,
+    LessEquals,
+    Greater,
+    GreaterEquals,
+    Plus,
+    Minus,
+    Star,
+    Caret,
+    Percent,
+    LeftParen,
+    RightParen,
+    LeftBrace,
+    RightBrace,
+    LeftBracket,
+    RightBracket,
+    Comma,
+    Semicolon,
+    Invalid,
+
+    NumStates,
+    Stop = NumStates
+};
+
+constexpr std::size_t NumClasses = static_cast<std::size_t>(CharClass::NumClasses);
+constexpr std::size_t NumStates = static_cast<std::size_t>(State::NumStates);
+
+// Runs of characters that are skipped in bulk (see lexer/scanner.hpp) as soon
+// as the lexer enters the corresponding state.
+enum class Run : std::uint8_t {
+    None,
+    Whitespace,
+    IdentifierChars,
+    Digits,
+    LineBody,
+    StringBody,
+};
+
+struct StateInfo {
+    // Token emitted when the automaton stops in this state.
+    std::optional<TokenType> token;
+
+    // Error reported when the automaton stops in this state without emitting
+    // a token, or follows a transition out of this state that is marked as an
+    // error.
+    const char *error = nullptr;
+
+    // Characters skipped in bulk when entering this state.
+    Run run = Run::None;
+};
+
+// A transition consists of the next state, and a flag that is set if taking
+// the transition should report the error of the current state.
+struct Transition {
+    State next = State::Stop;
+    bool error = false;
+};
+
+using CharClassTable = std::array<CharClass, 256>;
+using TransitionTable = std::array<std::array<Transition, NumClasses>, NumStates>;
+using StateTable = std::array<StateInfo, NumStates>;
+
+constexpr CharClassTable makeCharClasses() {
+    CharClassTable classes{};
+
+    for (auto &cls : classes)
+        cls = CharClass::Other;
+
+    for (int c = '0'; c <= '9'; ++c)
+        classes[c] = CharClass::Digit;
+    for (int c = 'a'; c <= 'z'; ++c)
+        classes[c] = CharClass::IdentifierStart;
+    for (int c = 'A'; c <= 'Z'; ++c)
+        classes[c] = CharClass::IdentifierStart;
+    classes['_'] = CharClass::IdentifierStart;
+
+    classes[' '] = CharClass::Whitespace;
+    classes['\t'] = CharClass::Whitespace;
+    classes['\r'] = CharClass::Whitespace;
+    classes['\n'] = CharClass::Newline;
+
+    classes['.'] = CharClass::Dot;
+    classes['"'] = CharClass::Quote;
+    classes['/'] = CharClass::Slash;
+    classes['='] = CharClass::Equals;
+    classes['!'] = CharClass::Bang;
+    classes['<'] = CharClass::Less;
+    classes['>'] = CharClass::Greater;
+    classes['+'] = CharClass::Plus;
+    classes['-'] = CharClass::Minus;
+    classes['*'] = CharClass::Star;
+    classes['^'] = CharClass::Caret;
+    classes['%'] = CharClass::Percent;
+    classes['('] = CharClass::LeftParen;
+    classes[')'] = CharClass::RightParen;
+    classes['{'] = CharClass::LeftBrace;
+    classes['}'] = CharClass::RightBrace;
+    classes['['] = CharClass::LeftBracket;
+    classes[']'] = CharClass::RightBracket;
+    classes[','] = CharClass::Comma;
+    classes[';'] = CharClass::Semicolon;
+
+    return classes;
+}
+
+constexpr TransitionTable makeTransitions() {
+    TransitionTable table{};
+
+    auto set = [&table](State from, CharClass cls, State to,
+                        bool error = false) {
+        table[static_cast<std::size_t>(from)][static_cast<std::size_t>(cls)] =
+            Transition{to, error};
+    };
+
+    auto setAll = [&table](State from, State to) {
+        for (auto &transition : table[static_cast<std::size_t>(from)])
+            transition = Transition{to, false};
+    };
+
+    // By default, the automaton stops.
+    for (std::size_t state = 0; state < NumStates; ++state)
+        setAll(static_cast<State>(state), State::Stop);
+
+    // Start of a token. Every character leads somewhere, so that the lexer
+    // always makes progress.
+    setAll(State::Start, State::Invalid);
+    set(State::Start, CharClass::EndOfInput, State::Stop);
+    set(State::Start, CharClass::Whitespace, State::Whitespace);
+    set(State::Start, CharClass::Newline, State::Whitespace);
+    set(State::Start, CharClass::Digit, State::Integer);
+    set(State::Start, CharClass::IdentifierStart, State::Identifier);
+    set(State::Start, CharClass::Quote, State::String);
+    set(State::Start, CharClass::Slash, State::Slash);
+    set(State::Start, CharClass::Equals, State::Equals);
+    set(State::Start, CharClass::Bang, State::Bang);
+    set(State::Start, CharClass::Less, State::Less);
+    set(State::Start, CharClass::Greater, State::Greater);
+    set(State::Start, CharClass::Plus, State::Plus);
+    set(State::Start, CharClass::Minus, State::Minus);
+    set(State::Start, CharClass::Star, State::Star);
+    set(State::Start, CharClass::Caret, State::Caret);
+    set(State::Start, CharClass::Percent, State::Percent);
+    set(State::Start, CharClass::LeftParen, State::LeftParen);
+    set(State::Start, CharClass::RightParen, State::RightParen);
+    set(State::Start, CharClass::LeftBrace, State::LeftBrace);
+    set(State::Start, CharClass::RightBrace, State::RightBrace);
+    set(State::Start, CharClass::LeftBracket, State::LeftBracket);
+    set(State::Start, CharClass::RightBracket, State::RightBracket);
+    set(State::Start, CharClass::Comma, State::Comma);
+    set(State::Start, CharClass::Semicolon, State::Semicolon);
+
+    // Whitespace
+    set(State::Whitespace, CharClass::Whitespace, State::Whitespace);
+    set(State::Whitespace, CharClass::Newline, State::Whitespace);
+
+    // Identifiers and keywords
+    set(State::Identifier, CharClass::IdentifierStart, State::Identifier);
+    set(State::Identifier, CharClass::Digit, State::Identifier);
+
+    // Numeric literals. Every decimal point after the first one is an error,
+    // but is still part of the literal.
+    set(State::Integer, CharClass::Digit, State::Integer);
+    set(State::Integer, CharClass::Dot, State::Float);
+    set(State::Float, CharClass::Digit, State::Float);
+    set(State::Float, CharClass::Dot, State::Float, true);
+
+    // Slash and comments
+    set(State::Slash, CharClass::Slash, State::Comment);
+    setAll(State::Comment, State::Comment);
+    set(State::Comment, CharClass::Newline, State::Stop);
+    set(State::Comment, CharClass::EndOfInput, State::Stop);
+
+    // String literals. A newline terminates the literal with an error.
+    setAll(State::String, State::String);
+    set(State::String, CharClass::Quote, State::StringEnd);
+    set(State::String, CharClass::Newline, State::StringEnd, true);
+    set(State::String, CharClass::EndOfInput, State::Stop);
+
+    // Multi-character operators
+    set(State::Equals, CharClass::Equals, State::EqualsEquals);
+    set(State::Bang, CharClass::Equals, State::BangEquals);
+    set(State::Less, CharClass::Equals, State::LessEquals);
+    set(State::Greater, CharClass::Equals, State::GreaterEquals);
+
+    return table;
+}
+
+constexpr StateTable makeStates() {
+    StateTable states{};
+
+    auto set = [&states](State state, StateInfo info) {
+        states[static_cast<std::size_t>(state)] = info;
+    };
+
+    set(State::Whitespace, {std::nullopt, nullptr, Run::Whitespace});
+    set(State::Identifier,
+        {TokenType::IDENTIFIER, nullptr, Run::IdentifierChars});
+    set(State::Integer, {TokenType::INT_LITERAL, nullptr, Run::Digits});
+    set(State::Float,
+        {TokenType::FLOAT_LITERAL,
+         "Float literals must only contain one decimal point", Run::Digits});
+    set(State::Slash, {TokenType::SLASH});
+    set(State::Comment, {std::nullopt, nullptr, Run::LineBody});
+    set(State::String,
+        {std::nullopt, "Unterminated string literal", Run::StringBody});
+    set(State::StringEnd, {TokenType::STRING_LITERAL});
+    set(State::Equals, {TokenType::EQUALS});
+    set(State::EqualsEquals, {TokenType::EQUALS_EQUALS});
+    set(State::Bang, {std::nullopt, "Expected '=' after '!'"});
+    set(State::BangEquals, {TokenType::BANG_EQUALS});
+    set(State::Less, {TokenType::LESS_THAN});
+    set(State::LessEquals, {TokenType::LESS_THAN_EQUALS});
+    set(State::Greater, {TokenType::GREATER_THAN});
+    set(State::GreaterEquals, {TokenType::GREATER_THAN_EQUALS});
+    set(State::Plus, {TokenType::PLUS});
+    set(State::Minus, {TokenType::MINUS});
+    set(State::Star, {TokenType::STAR});
+    set(State::Caret, {TokenType::CARET});
+    set(State::Percent, {TokenType::PERCENT});
+    set(State::LeftParen, {TokenType::LEFT_PAREN});
+    set(State::RightParen, {TokenType::RIGHT_PAREN});
+    set(State::LeftBrace, {TokenType::LEFT_BRACE});
+    set(State::RightBrace, {TokenType::RIGHT_BRACE});
+    set(State::LeftBracket, {TokenType::LEFT_BRACKET});
+    set(State::RightBracket, {TokenType::RIGHT_BRACKET});
+    set(State::Comma, {TokenType::COMMA});
+    set(State::Semicolon, {TokenType::SEMICOLON});
+    // NOTE: The message for invalid characters includes the character itself,
+    // so it is formatted by the lexer.
+    set(State::Invalid, {std::nullopt, "Invalid character"});
+
+    return states;
+}
+
+inline constexpr CharClassTable charClasses = makeCharClasses();
+inline constexpr TransitionTable transitions = makeTransitions();
+inline constexpr StateTable states = makeStates();
+
+constexpr CharClass classify(char c) {
+    return charClasses[static_cast<unsigned char>(c)];
+}
+
+constexpr Transition transition(State from, CharClass cls) {
+    return transitions[static_cast<std::size_t>(from)]
+                      [static_cast<std::size_t>(cls)];
+}
+
+constexpr const StateInfo &info(State state) {
+    return states[static_cast<std::size_t>(state)];
+}
+
+} // namespace dfa
+
+#endif /* end of include guard: DFA_HPP */
@@ -0,0 +1,161 @@
+#include "lexer/incrementallexer.hpp"
+
+#include <cassert>
+#include <utility>
+
+namespace {
+
+// Returns the first index in [first, last) for which pred is false, given that
+// pred is true for a prefix of the range.
+template <typename Pred>
+std::size_t partitionPoint(std::size_t first, std::size_t last, Pred pred) {
+    while (first < last) {
+        std::size_t middle = first + (last - first) / 2;
+
+        if (pred(middle))
+            first = middle + 1;
+        else
+            last = middle;
+    }
+
+    return first;
+}
+
+} // namespace
+
+IncrementalLexer::IncrementalLexer(std::string text)
+    : text(std::move(text)), tokens(this->text) {
+    Lexer lexer{this->text};
+    lexer.deferErrors();
+
+    while (std::optional<Token> token = lexer.next())
+        appendToken(tokens, *token);
+
+    appendErrors(errors, lexer, static_cast<std::uint32_t>(this->text.size()));
+
+    relexedCount = tokens.size();
+    sourceManager.emplace(this->text);
+}
+
+void IncrementalLexer::edit(std::uint32_t offset, std::uint32_t removed,
+                            std::string_view inserted) {
+    assert(offset <= text.size() && removed <= text.size() - offset &&
+           "Edit is out of range!");
+
+    std::int64_t delta = static_cast<std::int64_t>(inserted.size()) - removed;
+    std::uint32_t editEnd = offset + removed;
+
+    auto tokenEnd = [this](std::size_t i) {
+        return tokens.getOffset(i) + tokens.getLength(i);
+    };
+
+    // The first token that does not end before the edit may change, since
+    // the character after a token decides where it ends. Lexing restarts
+    // where the token before it ends.
+    std::size_t first = partitionPoint(
+        0, tokens.size(), [&](std::size_t i) { return tokenEnd(i) < offset; });
+    std::uint32_t from = first == 0 ? 0 : tokenEnd(first - 1);
+
+    // Only tokens that start behind the edit can be reused.
+    std::size_t next =
+        partitionPoint(first, tokens.size(), [&](std::size_t i) {
+            return tokens.getOffset(i) < editEnd;
+        });
+
+    text.replace(offset, removed, inserted);
+
+    Lexer lexer{text, std::string_view(text).substr(from)};
+    lexer.deferErrors();
+
+    TokenBuffer relexed{text};
+    relexedCount = 0;
+
+    // Offset in the new text from which the old tokens are reused.
+    std::uint32_t syncOffset = static_cast<std::uint32_t>(text.size());
+
+    while (std::optional<Token> token = lexer.next()) {
+        ++relexedCount;
+
+        auto tokenOffset =
+            static_cast<std::uint32_t>(token->lexeme.data() - text.data());
+
+        while (next < tokens.size() && tokens.getOffset(next) + delta < tokenOffset)
+            ++next;
+
+        if (next < tokens.size() && tokens.getOffset(next) + delta == tokenOffset) {
+            syncOffset = tokenOffset;
+            break;
+        }
+
+        appendToken(relexed, *token);
+    }
+
+    if (syncOffset == text.size())
+        next = tokens.size();
+
+    // Keep the old errors before from and behind syncOffset, and replace the
+    // ones in between by those of the lexer.
+    std::vector<Error> newErrors;
+
+    std::size_t i = 0;
+    for (; i < errors.size() && errors[i].runBegin < from; ++i)
+        newErrors.push_back(std::move(errors[i]));
+
+    appendErrors(newErrors, lexer, syncOffset);
+
+    for (; i < errors.size(); ++i) {
+        if (errors[i].runBegin + delta < syncOffset)
+            continue;
+
+        Error &error = newErrors.emplace_back(std::move(errors[i]));
+        error.runBegin = static_cast<std::uint32_t>(error.runBegin + delta);
+        error.position = static_cast<std::uint32_t>(error.position + delta);
+    }
+
+    errors = std::move(newErrors);
+
+    tokens.replace(first, next, relexed, delta);
+    sourceManager.emplace(text);
+}
+
+std::string_view IncrementalLexer::getText() const { return text; }
+
+const TokenBuffer &IncrementalLexer::getTokens() const { return tokens; }
+
+const std::vector<IncrementalLexer::Error> &
+IncrementalLexer::getErrors() const {
+    return errors;
+}
+
+bool IncrementalLexer::hadError() const { return !errors.empty(); }
+
+const SourceManager &IncrementalLexer::getSourceManager() const {
+    return *sourceManager;
+}
+
+const IdentifierTable &IncrementalLexer::getIdentifierTable() const {
+    return identifiers;
+}
+
+std::size_t IncrementalLexer::getRelexedCount() const { return relexedCount; }
+
+void IncrementalLexer::appendToken(TokenBuffer &buffer, Token token) {
+    if (token.type == TokenType::IDENTIFIER)
+        token.identifier = identifiers.get(token.lexeme);
+
+    buffer.push_back(token);
+}
+
+void IncrementalLexer::appendErrors(std::vector<Error> &list,
+                                    const Lexer &lexer,
+                                    std::uint32_t before) const {
+    for (const Lexer::Error &error : lexer.getErrors()) {
+        auto runBegin = static_cast<std::uint32_t>(error.runBegin - text.data());
+        if (runBegin >= before)
+            continue;
+
+        list.push_back(
+            {runBegin, static_cast<std::uint32_t>(error.position - text.data()),
+             error.message});
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef INCREMENTALLEXER_HPP
+#define INCREMENTALLEXER_HPP
+
+#include "lexer/identifiertable.hpp"
+#include "lexer/lexer.hpp"
+#include "lexer/sourcemanager.hpp"
+#include "lexer/tokenbuffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Keeps the token stream of a text up to date while the text is edited, e.g.
+// in an editor.
+//
+// After an edit, lexing restarts at the end of the last token that ends before
+// the edit: everything up to and including the character after that token is
+// unchanged, so the lexer was in its start state there. It stops as soon as a
+// new token starts at the same place as an old token behind the edit, since
+// the lexer is in the same state with the same text ahead from there on. Only
+// the tokens in between are replaced; the offsets of all later tokens are
+// shifted. The work per edit is therefore proportional to the size of the edit
+// and the tokens around it, apart from moving the text and the token arrays.
+class IncrementalLexer {
+  public:
+    IncrementalLexer(std::string text);
+
+    // The tokens refer to the text, which lives in this object.
+    IncrementalLexer(const IncrementalLexer &) = delete;
+    IncrementalLexer &operator=(const IncrementalLexer &) = delete;
+
+    // An error that was reported while lexing. Unlike Lexer::Error, this uses
+    // offsets, since the text moves when it is edited.
+    struct Error {
+        // Offset of the beginning of the run of characters with the error.
+        std::uint32_t runBegin;
+
+        // Offset at which the error was reported.
+        std::uint32_t position;
+
+        std::string message;
+    };
+
+    // Replaces the removed bytes at offset by inserted, and updates the tokens
+    // and errors.
+    void edit(std::uint32_t offset, std::uint32_t removed,
+              std::string_view inserted);
+
+    std::string_view getText() const;
+
+    // Returns the tokens of the current text.
+    const TokenBuffer &getTokens() const;
+
+    // Returns the errors in the current text, in order of appearance.
+    const std::vector<Error> &getErrors() const;
+
+    bool hadError() const;
+
+    // Returns the source manager that computes the locations of the tokens.
+    const SourceManager &getSourceManager() const;
+
+    // Returns the table with the interned spellings of all identifiers seen so
+    // far, including those that were edited away since.
+    const IdentifierTable &getIdentifierTable() const;
+
+    // Returns the number of tokens that were lexed for the last edit.
+    std::size_t getRelexedCount() const;
+
+  private:
+    std::string text;
+
+    TokenBuffer tokens;
+    std::vector<Error> errors;
+    IdentifierTable identifiers;
+
+    // Recreated for every edit, since its line table is for the old text.
+    std::optional<SourceManager> sourceManager;
+
+    std::size_t relexedCount = 0;
+
+    // Appends a token to buffer, after interning its identifier (if any) in
+    // the shared table.
+    void appendToken(TokenBuffer &buffer, Token token);
+
+    // Appends the errors of lexer that occur in runs starting before the
+    // given offset to list.
+    void appendErrors(std::vector<Error> &list, const Lexer &lexer,
+                      std::uint32_t before) const;
+};
+
+#endif /* end of include guard: INCREMENTALLEXER_HPP */
@@ -0,0 +1,143 @@
+#ifndef KEYWORDS_HPP
+#define KEYWORDS_HPP
+
+// Keyword recognition using a perfect hash that is generated at compile time.
+//
+// The hash combines the length, first and last character of the lexeme into a
+// key, and maps it to a slot in a small power-of-two table using
+// multiply-shift hashing. At compile time, we search for the smallest table
+// and multiplier for which every keyword ends up in its own slot. Classifying
+// an identifier then costs one multiplication and at most one comparison, no
+// matter how many keywords there are.
+//
+// To add a keyword, add it to the list below; the table is regenerated
+// automatically. If two keywords have the same length, first and last
+// character, the static_assert below fires and the key needs to include
+// another character.
+
+#include "lexer/token.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace keywords {
+
+struct Keyword {
+    std::string_view spelling;
+    TokenType type;
+};
+
+inline constexpr std::array<Keyword, 5> list{{
+    {"return", TokenType::RETURN},
+    {"if", TokenType::IF},
+    {"else", TokenType::ELSE},
+    {"while", TokenType::WHILE},
+    {"for", TokenType::FOR},
+}};
+
+constexpr std::size_t computeMinLength() {
+    std::size_t result = list[0].spelling.size();
+    for (const Keyword &keyword : list)
+        result = keyword.spelling.size() < result ? keyword.spelling.size()
+                                                  : result;
+    return result;
+}
+
+constexpr std::size_t computeMaxLength() {
+    std::size_t result = 0;
+    for (const Keyword &keyword : list)
+        result = keyword.spelling.size() > result ? keyword.spelling.size()
+                                                  : result;
+    return result;
+}
+
+inline constexpr std::size_t minLength = computeMinLength();
+inline constexpr std::size_t maxLength = computeMaxLength();
+
+constexpr std::uint32_t key(std::string_view text) {
+    return static_cast<std::uint32_t>(text.size()) << 16 |
+           static_cast<std::uint32_t>(static_cast<unsigned char>(text.front()))
+               << 8 |
+           static_cast<unsigned char>(text.back());
+}
+
+struct Parameters {
+    std::uint32_t multiplier = 0;
+    unsigned int bits = 0;
+};
+
+constexpr std::size_t slot(std::string_view text, Parameters parameters) {
+    return (key(text) * parameters.multiplier) >> (32 - parameters.bits);
+}
+
+// Returns true if every keyword gets its own slot for the given parameters.
+constexpr bool isPerfect(Parameters parameters) {
+    std::array<bool, 256> used{};
+
+    for (const Keyword &keyword : list) {
+        std::size_t index = slot(keyword.spelling, parameters);
+        if (used[index])
+            return false;
+        used[index] = true;
+    }
+
+    return true;
+}
+
+constexpr Parameters findParameters() {
+    for (unsigned int bits = 1; bits <= 8; ++bits) {
+        if ((std::size_t{1} << bits) < list.size())
+            continue;
+
+        // Odd multipliers spread the key over the high bits best.
+        for (std::uint32_t multiplier = 1; multiplier < 2 * 4096;
+             multiplier += 2)
+            if (isPerfect(Parameters{multiplier * 0x9E3779B1u, bits}))
+                return Parameters{multiplier * 0x9E3779B1u, bits};
+    }
+
+    return Parameters{};
+}
+
+inline constexpr Parameters parameters = findParameters();
+static_assert(parameters.bits != 0, "no perfect hash found for the keywords");
+
+inline constexpr std::size_t tableSize = std::size_t{1} << parameters.bits;
+
+// Every keyword is stored in its slot; empty slots hold an empty spelling.
+constexpr std::array<Keyword, tableSize> makeTable() {
+    std::array<Keyword, tableSize> table{};
+
+    for (std::size_t i = 0; i < tableSize; ++i)
+        table[i] = Keyword{std::string_view{}, TokenType::IDENTIFIER};
+
+    for (const Keyword &keyword : list)
+        table[slot(keyword.spelling, parameters)] = keyword;
+
+    return table;
+}
+
+inline constexpr std::array<Keyword, tableSize> table = makeTable();
+
+// Returns the token type of an identifier, which is either a keyword or
+// IDENTIFIER.
+constexpr TokenType classify(std::string_view identifier) {
+    if (identifier.size() < minLength || identifier.size() > maxLength)
+        return TokenType::IDENTIFIER;
+
+    const Keyword &candidate = table[slot(identifier, parameters)];
+
+    if (candidate.spelling == identifier)
+        return candidate.type;
+
+    return TokenType::IDENTIFIER;
+}
+
+static_assert(classify("while") == TokenType::WHILE);
+static_assert(classify("whilst") == TokenType::IDENTIFIER);
+
+} // namespace keywords
+
+#endif /* end of include guard: KEYWORDS_HPP */
@@ -1,212 +1,232 @@
 #include "lexer.hpp"
+#include "lexer/dfa.hpp"
+#include "lexer/keywords.hpp"
+#include "lexer/scanner.hpp"
+#include "lexer/utf8.hpp"
 
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 
-#include <cstdio>
+#include <cassert>
+#include <charconv>
 #include <fmt/core.h>
-#include <iostream>
-#include <iterator>
+#include <system_error>
+#include <utility>
 
 #define DEBUG_TYPE "lexer"
 
-Lexer::Lexer(const std::string &input)
-    : input(input), begin_location(1, 1), end_location(1, 1) {
-    begin = end = std::begin(this->input);
+Lexer::Lexer(std::string_view input) : Lexer(input, input) {}
+
+Lexer::Lexer(std::string_view input, DiagnosticEngine &diagnostics)
+    : Lexer(input) {
+    this->diagnostics = &diagnostics;
 }
 
-std::vector<Token> Lexer::getTokens() {
-    while (!isAtEnd()) {
-        lexToken();
+Lexer::Lexer(std::string_view input, std::string_view range)
+    : input(input), sourceManager(input) {
+    assert(range.data() >= input.data() &&
+           range.data() + range.size() <= input.data() + input.size() &&
+           "Range is not a part of the input!");
+
+    begin = end = range.data();
+    rangeEnd = range.data() + range.size();
+}
+
+std::optional<Token> Lexer::next() {
+    while (begin < rangeEnd) {
+        if (diagnostics && diagnostics->reachedErrorLimit())
+            break;
+
+        std::optional<Token> token = lexToken();
 
         begin = end;
-        begin_location = end_location;
+
+        if (token)
+            return token;
     }
 
+    return std::nullopt;
+}
+
+std::vector<Token> Lexer::getTokens() {
+    std::vector<Token> tokens;
+
+    while (std::optional<Token> token = next())
+        tokens.push_back(*token);
+
+    return tokens;
+}
+
+TokenBuffer Lexer::getTokenBuffer() {
+    TokenBuffer tokens{input};
+
+    while (std::optional<Token> token = next())
+        tokens.push_back(*token);
+
     return tokens;
 }
 
 bool Lexer::hadError() const { return errorFlag; }
 
-bool Lexer::isAtEnd() const { return end == std::end(input); }
+void Lexer::deferErrors() { deferringErrors = true; }
+
+const std::vector<Lexer::Error> &Lexer::getErrors() const { return errors; }
+
+void Lexer::printError(const SourceManager &sourceManager,
+                       const Error &error) {
+    Location location = sourceManager.getLocation(error.position);
+    llvm::WithColor::error(llvm::errs(), "lexer") << fmt::format(
+        "{}:{}: {}\n", location.line, location.col, error.message);
+}
+
+const char *Lexer::getPosition() const { return begin; }
+
+const SourceManager &Lexer::getSourceManager() const { return sourceManager; }
+
+const IdentifierTable &Lexer::getIdentifierTable() const { return identifiers; }
 
-void Lexer::lexToken() {
+bool Lexer::isAtEnd() const { return end == inputEnd(); }
+
+const char *Lexer::inputEnd() const { return input.data() + input.size(); }
+
+std::optional<Token> Lexer::lexToken() {
     // ASSIGNMENT: Implement the lexical analyser here.
-    char c = peek();
-    advance();
+    dfa::State state = dfa::State::Start;
 
-    switch (c) {
-    // Parse whitespace characters
-    case ' ':
-        break;
-    case '\t':
-        break;
-    case '\n':
-        break;
-    case '\r':
-        break;
-    // Parse single character tokens
-    case ',':
-        emitToken(TokenType::COMMA);
-        break;
-    case ';':
-        emitToken(TokenType::SEMICOLON);
-        break;
-    case '(':
-        emitToken(TokenType::LEFT_PAREN);
-        break;
-    case ')':
-        emitToken(TokenType::RIGHT_PAREN);
-        break;
-    case '{':
-        emitToken(TokenType::LEFT_BRACE);
-        break;
-    case '}':
-        emitToken(TokenType::RIGHT_BRACE);
-        break;
-    case '[':
-        emitToken(TokenType::LEFT_BRACKET);
-        break;
-    case ']':
-        emitToken(TokenType::RIGHT_BRACKET);
-        break;
-    case '=':
-        if (peek() == '=') {
-            advance();
-            emitToken(TokenType::EQUALS_EQUALS);
-        } else {
-            emitToken(TokenType::EQUALS);
-        }
-        break;
-    case '<':
-        if (peek() == '=') {
-            advance();
-            emitToken(TokenType::LESS_THAN_EQUALS);
-        } else {
-            emitToken(TokenType::LESS_THAN);
-        }
-        break;
-    case '>':
-        if (peek() == '=') {
-            advance();
-            emitToken(TokenType::GREATER_THAN_EQUALS);
-        } else {
-            emitToken(TokenType::GREATER_THAN);
-        }
-        break;
-    case '+':
-        emitToken(TokenType::PLUS);
-        break;
-    case '-':
-        emitToken(TokenType::MINUS);
-        break;
-    case '*':
-        emitToken(TokenType::STAR);
-        break;
-    case '/':
-        if (peek() == '/') {
-            while (peek() != '\n' && !isAtEnd()) {
-                advance();
-            }
+    while (true) {
+        dfa::CharClass cls =
+            isAtEnd() ? dfa::CharClass::EndOfInput : dfa::classify(peek());
+        dfa::Transition transition = dfa::transition(state, cls);
+
+        if (transition.next == dfa::State::Stop)
             break;
+
+        if (transition.error)
+            error(dfa::info(state).error);
+
+        ++end;
+        state = transition.next;
+        skipRun(dfa::info(state).run);
+    }
+
+    const dfa::StateInfo &info = dfa::info(state);
+
+    if (info.token) {
+        switch (*info.token) {
+        case TokenType::IDENTIFIER:
+            return makeIdentifier();
+        case TokenType::INT_LITERAL:
+            return makeIntLiteral();
+        case TokenType::FLOAT_LITERAL:
+            return makeFloatLiteral();
+        default:
+            return makeToken(*info.token);
         }
-        emitToken(TokenType::SLASH);
+    } else if (state == dfa::State::Invalid) {
+        invalidCharacter(info.error);
+    } else if (info.error) {
+        error(info.error);
+    }
+
+    return std::nullopt;
+}
+
+void Lexer::skipRun(dfa::Run run) {
+    switch (run) {
+    case dfa::Run::None:
         break;
-    case '^':
-        emitToken(TokenType::CARET);
+    case dfa::Run::Whitespace:
+        advanceTo(scanner::skip<scanner::Whitespace>(end, inputEnd()));
         break;
-    case '%':
-        emitToken(TokenType::PERCENT);
+    case dfa::Run::IdentifierChars:
+        advanceTo(scanner::skip<scanner::IdentifierChars>(end, inputEnd()));
         break;
-    case '!':
-        if (peek() != '=') {
-            error("Expected '=' after '!'");
-            break;
-        }
-        advance();
-        emitToken(TokenType::BANG_EQUALS);
+    case dfa::Run::Digits:
+        advanceTo(scanner::skip<scanner::Digits>(end, inputEnd()));
         break;
-    case '"':
-        while (peek() != '"' && !isAtEnd()) {
-            if (peek() == '\n') {
-                error("Unterminated string literal");
-                break;
-            }
-            advance();
-        }
-        if (isAtEnd()) {
-            error("Unterminated string literal");
-        } else {
-            advance();
-            emitToken(TokenType::STRING_LITERAL);
-        }
+    case dfa::Run::LineBody:
+        skipText<scanner::LineBody>();
         break;
-    default:
-        if (isdigit(c)) {
-            while (isdigit(peek()))
-                advance();
-
-            if (peek() == '.') {
-                advance();
-
-                while (isdigit(peek()) || peek() == '.') {
-                    if (peek() == '.') {
-                        error("Float literals must only contain one decimal point");
-                    }
-
-                    advance();
-                }
-                emitToken(TokenType::FLOAT_LITERAL);
-            } else {
-                emitToken(TokenType::INT_LITERAL);
-            }
-            break;
-        }
-        if (isalpha(c) || c == '_') {
-            std::string identifier = "";
-            identifier += c;
-            while (isalnum(peek()) || peek() == '_') {
-                identifier += peek();
-                advance();
-            }
-            if (identifier == "return") {
-                emitToken(TokenType::RETURN);
-            } else if (identifier == "if") {
-                emitToken(TokenType::IF);
-            } else if (identifier == "else") {
-                emitToken(TokenType::ELSE);
-            } else if (identifier == "while") {
-                emitToken(TokenType::WHILE);
-            } else if (identifier == "for") {
-                emitToken(TokenType::FOR);
-            } else {
-                emitToken(TokenType::IDENTIFIER);
-            }
-            break;
-        }
-        error(fmt::format("Invalid character '{}'", c));
+    case dfa::Run::StringBody:
+        skipText<scanner::StringBody>();
         break;
     }
 }
 
-void Lexer::emitToken(TokenType type) {
-    tokens.emplace_back(type, begin_location, end_location, getLexeme());
+template <typename Class> void Lexer::skipText() {
+    const char *p = scanner::skip<scanner::Ascii<Class>>(end, inputEnd());
+
+    // Most text is ASCII. Otherwise, find the end of the run, and check that
+    // the rest of it is valid UTF-8.
+    if (p != inputEnd() && !scanner::isAscii(*p)) {
+        const char *runEnd = scanner::skip<Class>(p, inputEnd());
+
+        while ((p = utf8::findInvalid(p, runEnd)) != runEnd) {
+            std::size_t length = utf8::invalidLength(p, runEnd);
+            error(p, {p, length}, "Invalid UTF-8 sequence");
+            p += length;
+        }
+    }
+
+    advanceTo(p);
 }
 
-void Lexer::advance() {
-    // Update location information
-    if (peek() == '\n') {
-        ++end_location.line;
-        end_location.col = 1;
+void Lexer::invalidCharacter(const char *message) {
+    if (scanner::isAscii(*begin)) {
+        error(fmt::format("{} '{}'", message, *begin));
+        return;
+    }
+
+    // Report a multibyte character once, instead of once for every byte.
+    if (std::size_t length = utf8::sequenceLength(begin, inputEnd())) {
+        advanceTo(begin + length);
+        error(fmt::format("{} '{}'", message, getLexeme()));
     } else {
-        ++end_location.col;
+        advanceTo(begin + utf8::invalidLength(begin, inputEnd()));
+        error("Invalid UTF-8 sequence");
     }
+}
 
-    if (!isAtEnd())
-        ++end;
+Token Lexer::makeToken(TokenType type) const {
+    return Token(type, getLexeme());
+}
+
+Token Lexer::makeIdentifier() {
+    std::string_view lexeme = getLexeme();
+    TokenType type = keywords::classify(lexeme);
+
+    if (type != TokenType::IDENTIFIER)
+        return makeToken(type);
+
+    return Token(type, lexeme, identifiers.get(lexeme));
+}
+
+Token Lexer::makeIntLiteral() {
+    Token token = makeToken(TokenType::INT_LITERAL);
+    token.intValue = 0;
+
+    if (std::from_chars(begin, end, token.intValue).ec ==
+        std::errc::result_out_of_range)
+        error(begin, getLexeme(), "Integer literal is out of range");
+
+    return token;
 }
 
+Token Lexer::makeFloatLiteral() {
+    Token token = makeToken(TokenType::FLOAT_LITERAL);
+    token.floatValue = 0;
+
+    if (std::from_chars(begin, end, token.floatValue,
+                        std::chars_format::fixed)
+            .ec == std::errc::result_out_of_range)
+        error(begin, getLexeme(), "Float literal is out of range");
+
+    return token;
+}
+
+void Lexer::advanceTo(const char *position) { end = position; }
+
 char Lexer::peek() {
     if (!isAtEnd())
         return *end;
@@ -215,9 +235,23 @@ char Lexer::peek() {
 }
 
 void Lexer::error(const std::string &message) {
+    error(end, getLexeme(), message);
+}
+
+void Lexer::error(const char *position, std::string_view text,
+                  const std::string &message) {
     errorFlag = true;
-    llvm::WithColor::error(llvm::errs(), "lexer") << fmt::format(
-        "{}:{}: {}\n", end_location.line, end_location.col, message);
+
+    Error reported{begin, position, text, message};
+
+    if (deferringErrors)
+        errors.push_back(std::move(reported));
+    else if (diagnostics)
+        diagnostics->error("lexer", position, text, message);
+    else
+        printError(sourceManager, reported);
 }
 
-std::string Lexer::getLexeme() const { return std::string{begin, end}; }
+std::string_view Lexer::getLexeme() const {
+    return std::string_view{begin, static_cast<std::size_t>(end - begin)};
+}
@@ -0,0 +1,296 @@
+#include "lexer/parallellexer.hpp"
+#include "lexer/lexer.hpp"
+#include "lexer/scanner.hpp"
+
+#include "llvm/Support/Threading.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <thread>
+
+namespace {
+
+// A part of the input that is lexed on its own.
+struct Chunk {
+    Chunk(std::string_view input, std::string_view range)
+        : range(range), lexer(input, range), tokens(input) {
+        lexer.deferErrors();
+    }
+
+    void lex() {
+        while (std::optional<Token> token = lexer.next())
+            tokens.push_back(*token);
+    }
+
+    std::string_view range;
+    Lexer lexer;
+    TokenBuffer tokens;
+};
+
+// Appends the errors that occur in runs starting in [from, to).
+void appendErrors(std::vector<Lexer::Error> &errors,
+                  const std::vector<Lexer::Error> &chunkErrors,
+                  const char *from, const char *to) {
+    for (const Lexer::Error &error : chunkErrors)
+        if (error.runBegin >= from && error.runBegin < to)
+            errors.push_back(error);
+}
+
+// Reports the errors of the merged token stream in order, and finds where the
+// sequential Lexer would stop at the error limit. Like the ThreadedLexer, it
+// checks the limit before every run of characters, i.e. before the first
+// error of a run and before a token that does not start the run of the
+// previous error.
+class ErrorReplay {
+  public:
+    ErrorReplay(const std::vector<Lexer::Error> &errors,
+                DiagnosticEngine *diagnostics,
+                const SourceManager &sourceManager)
+        : errors(errors), diagnostics(diagnostics),
+          sourceManager(sourceManager) {}
+
+    // Reports the errors that precede the token that starts at position, or
+    // all remaining errors if position is nullptr. Returns false if the
+    // sequential Lexer would have stopped before the token.
+    bool reportUntil(const char *position) {
+        for (; next < errors.size(); ++next) {
+            const Lexer::Error &error = errors[next];
+
+            if (position && error.runBegin > position)
+                break;
+
+            if (error.runBegin != lastRunBegin && reachedErrorLimit())
+                return false;
+
+            lastRunBegin = error.runBegin;
+
+            if (diagnostics)
+                diagnostics->error("lexer", error.position, error.text,
+                                   error.message);
+            else
+                Lexer::printError(sourceManager, error);
+        }
+
+        return !position || position == lastRunBegin || !reachedErrorLimit();
+    }
+
+  private:
+    const std::vector<Lexer::Error> &errors;
+    DiagnosticEngine *diagnostics;
+    const SourceManager &sourceManager;
+
+    // Index of the next error to report.
+    std::size_t next = 0;
+
+    // Beginning of the run of characters of the last error that was reported.
+    const char *lastRunBegin = nullptr;
+
+    bool reachedErrorLimit() const {
+        return diagnostics && diagnostics->reachedErrorLimit();
+    }
+};
+
+} // namespace
+
+ParallelLexer::ParallelLexer(std::string_view input, unsigned threads,
+                             std::size_t chunkSize)
+    : input(input), threads(threads),
+      chunkSize(std::max<std::size_t>(chunkSize, 1)), sourceManager(input) {}
+
+ParallelLexer::ParallelLexer(std::string_view input,
+                             DiagnosticEngine &diagnostics, unsigned threads,
+                             std::size_t chunkSize)
+    : ParallelLexer(input, threads, chunkSize) {
+    this->diagnostics = &diagnostics;
+}
+
+TokenBuffer ParallelLexer::getTokenBuffer() {
+    std::vector<std::string_view> ranges = split();
+
+    std::vector<Chunk> chunks;
+    chunks.reserve(ranges.size());
+    for (std::string_view range : ranges)
+        chunks.emplace_back(input, range);
+
+    // Every worker repeatedly takes the next chunk that nobody took yet.
+    std::atomic<std::size_t> nextChunk{0};
+    auto work = [&chunks, &nextChunk] {
+        std::size_t index;
+        while ((index = nextChunk.fetch_add(1)) < chunks.size())
+            chunks[index].lex();
+    };
+
+    unsigned workerCount =
+        threads ? threads : llvm::hardware_concurrency().compute_thread_count();
+    workerCount = std::min<std::size_t>(workerCount, chunks.size());
+
+    // The calling thread is one of the workers.
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < workerCount; ++i)
+        workers.emplace_back(work);
+
+    work();
+
+    for (std::thread &worker : workers)
+        worker.join();
+
+    std::size_t count = 0;
+    for (const Chunk &chunk : chunks)
+        count += chunk.tokens.size();
+
+    TokenBuffer tokens{input};
+    tokens.reserve(count);
+
+    std::vector<Lexer::Error> errors;
+    ErrorReplay replay{errors, diagnostics, sourceManager};
+
+    // Number of merged tokens whose preceding errors are reported.
+    std::size_t reported = 0;
+
+    // Set once the error limit stops the sequential lexer.
+    bool stopped = false;
+
+    // Reports the errors of the tokens that were merged so far. Returns false
+    // if the error limit stops the sequential lexer, after removing the tokens
+    // that it would not have produced.
+    auto report = [&] {
+        for (; reported < tokens.size(); ++reported) {
+            if (!replay.reportUntil(input.data() +
+                                    tokens.getOffset(reported))) {
+                tokens.truncate(reported);
+                stopped = true;
+                return false;
+            }
+        }
+
+        return true;
+    };
+
+    // Position where the sequential lexer would start its next token.
+    const char *position = input.data();
+
+    for (const Chunk &chunk : chunks) {
+        const char *rangeEnd = chunk.range.data() + chunk.range.size();
+
+        // The previous chunk consumed this one entirely.
+        if (position >= rangeEnd)
+            continue;
+
+        // Index of the first token of the chunk that is kept.
+        std::size_t first = 0;
+
+        if (position != chunk.range.data()) {
+            // Lex from position until a token starts at the same position as
+            // one of the tokens of the chunk.
+            Lexer lexer{input, std::string_view(position, rangeEnd - position)};
+            lexer.deferErrors();
+
+            const char *match = nullptr;
+
+            while (std::optional<Token> token = lexer.next()) {
+                std::uint32_t offset =
+                    sourceManager.getOffset(token->lexeme.data());
+
+                while (first < chunk.tokens.size() &&
+                       chunk.tokens.getOffset(first) < offset)
+                    ++first;
+
+                if (first < chunk.tokens.size() &&
+                    chunk.tokens.getOffset(first) == offset) {
+                    match = token->lexeme.data();
+                    break;
+                }
+
+                if (token->type == TokenType::IDENTIFIER)
+                    token->identifier = identifiers.get(token->lexeme);
+
+                tokens.push_back(*token);
+            }
+
+            appendErrors(errors, lexer.getErrors(), position,
+                         match ? match : lexer.getPosition());
+
+            if (!match) {
+                position = lexer.getPosition();
+
+                if (!report())
+                    break;
+
+                continue;
+            }
+
+            position = match;
+        }
+
+        // Move the identifiers of the chunk to the shared table, in order of
+        // appearance.
+        std::size_t appended = tokens.size();
+        tokens.append(chunk.tokens, first);
+
+        std::vector<Identifier> remap(chunk.lexer.getIdentifierTable().size());
+
+        for (std::size_t i = appended; i < tokens.size(); ++i) {
+            if (tokens.getType(i) != TokenType::IDENTIFIER)
+                continue;
+
+            Identifier identifier = tokens.getIdentifier(i);
+
+            Identifier &shared = remap[identifier.id];
+            if (!shared.isValid())
+                shared = identifiers.get(
+                    chunk.lexer.getIdentifierTable().getSpelling(identifier));
+
+            tokens.setIdentifier(i, shared);
+        }
+
+        appendErrors(errors, chunk.lexer.getErrors(), position,
+                     chunk.lexer.getPosition());
+
+        position = chunk.lexer.getPosition();
+
+        if (!report())
+            break;
+    }
+
+    // The errors after the last token, unless the lexer stopped before them.
+    if (!stopped)
+        replay.reportUntil(nullptr);
+
+    errorFlag = !errors.empty();
+
+    return tokens;
+}
+
+bool ParallelLexer::hadError() const { return errorFlag; }
+
+const SourceManager &ParallelLexer::getSourceManager() const {
+    return sourceManager;
+}
+
+const IdentifierTable &ParallelLexer::getIdentifierTable() const {
+    return identifiers;
+}
+
+std::vector<std::string_view> ParallelLexer::split() const {
+    std::vector<std::string_view> ranges;
+
+    const char *end = input.data() + input.size();
+    const char *p = input.data();
+
+    while (p != end) {
+        const char *next = end;
+
+        if (static_cast<std::size_t>(end - p) > chunkSize) {
+            next = scanner::skip<scanner::LineBody>(p + chunkSize, end);
+            if (next != end)
+                ++next;
+        }
+
+        ranges.emplace_back(p, next - p);
+        p = next;
+    }
+
+    return ranges;
+}
@@ -0,0 +1,79 @@
+#ifndef PARALLELLEXER_HPP
+#define PARALLELLEXER_HPP
+
+#include "lexer/diagnosticengine.hpp"
+#include "lexer/identifiertable.hpp"
+#include "lexer/sourcemanager.hpp"
+#include "lexer/tokenbuffer.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Lexes a large input on multiple threads.
+//
+// The input is split into chunks of roughly chunkSize bytes that end just
+// after a newline. A pool of worker threads lexes the chunks independently,
+// each as if a token starts at the beginning of the chunk, with their errors
+// deferred. The chunks are then merged in order into one token stream that is
+// identical to the one of the sequential Lexer:
+//
+// - If the previous chunk stopped somewhere after the beginning of a chunk
+//   (because its last run of characters crosses the boundary), the chunk is
+//   lexed again from that position until a token starts at the same position
+//   as one of the tokens of the chunk. From there on, both lexers agree.
+// - Identifiers are interned again in one table, in order of appearance.
+// - Only the errors in the part of a chunk that is kept are reported, in
+//   order, after the chunk is merged. Once the error limit is reached, the
+//   merge stops at the token where the sequential Lexer would stop.
+//
+// In MicroC, neither // comments nor string literals continue past a newline,
+// so a chunk never starts inside one of them and resynchronising costs at most
+// a few tokens. The merge does not rely on this, however.
+class ParallelLexer {
+  public:
+    static constexpr std::size_t defaultChunkSize = 1 << 20;
+
+    // NOTE: Like the Lexer, this does not copy the input, so the buffer must
+    // outlive both the lexer and the tokens it produces.
+    //
+    // The number of threads defaults to the number of hardware threads.
+    ParallelLexer(std::string_view input, unsigned threads = 0,
+                  std::size_t chunkSize = defaultChunkSize);
+
+    // Creates a parallel lexer that reports its errors to diagnostics.
+    ParallelLexer(std::string_view input, DiagnosticEngine &diagnostics,
+                  unsigned threads = 0,
+                  std::size_t chunkSize = defaultChunkSize);
+
+    // Lexes the entire input and returns all tokens, or those up to the error
+    // limit. Errors are printed (or reported) in order of appearance.
+    TokenBuffer getTokenBuffer();
+
+    bool hadError() const;
+
+    // Returns the source manager that computes the locations of the tokens.
+    const SourceManager &getSourceManager() const;
+
+    // Returns the table with the interned spellings of all identifiers.
+    const IdentifierTable &getIdentifierTable() const;
+
+  private:
+    std::string_view input;
+
+    unsigned threads;
+    std::size_t chunkSize;
+
+    SourceManager sourceManager;
+    IdentifierTable identifiers;
+
+    // Receives the errors, if set.
+    DiagnosticEngine *diagnostics = nullptr;
+
+    bool errorFlag = false;
+
+    // Splits the input into chunks that end just after a newline.
+    std::vector<std::string_view> split() const;
+};
+
+#endif /* end of include guard: PARALLELLEXER_HPP */
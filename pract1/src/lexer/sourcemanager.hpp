@@ -0,0 +1,78 @@
+#ifndef SOURCEMANAGER_HPP
+#define SOURCEMANAGER_HPP
+
+#include "lexer/token.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Maps positions in a source buffer to line and column numbers.
+//
+// Tokens only refer to their lexeme in the source buffer, so locations are
+// computed on demand, e.g. when a diagnostic is reported or when tokens are
+// dumped. The first such query builds a table with the offset of the start of
+// every line; every query after that is a binary search in that table, with a
+// fast path for queries that are close to the previous one.
+//
+// Columns count code points, so that a multibyte UTF-8 character is one
+// column; every byte of invalid UTF-8 is a column of its own. On lines that are
+// pure ASCII, which the table records, this is the same as counting bytes.
+//
+// NOTE: Offsets are 32-bit, so the source buffer may be at most 4 GiB.
+class SourceManager {
+  public:
+    // The size of the largest buffer whose offsets fit in 32 bits. The
+    // offsets of tokens (e.g. in a TokenBuffer or a token file) have the same
+    // limit, so the drivers reject larger inputs.
+    static constexpr std::size_t maxBufferSize = UINT32_MAX;
+
+    SourceManager(std::string_view buffer);
+
+    // Returns the location of a position in the buffer. The position may also
+    // point one-past-the-end of the buffer.
+    Location getLocation(const char *position) const;
+
+    // Returns the location of the first character of the token.
+    Location getBeginLocation(const Token &token) const;
+
+    // Returns the location one-past-the-end of the token.
+    Location getEndLocation(const Token &token) const;
+
+    // Returns the offset of a position in the buffer.
+    std::uint32_t getOffset(const char *position) const;
+
+    // Returns the buffer.
+    std::string_view getBuffer() const;
+
+  private:
+    std::string_view buffer;
+
+    // Offsets of the first character of every line, computed on first use.
+    mutable std::vector<std::uint32_t> lineOffsets;
+
+    // Whether each line is pure ASCII, computed along with lineOffsets.
+    mutable std::vector<bool> asciiLines;
+
+    // Index in lineOffsets of the line of the previous query.
+    mutable std::size_t lastLine = 0;
+
+    // Offset and column of the previous query on a line with non-ASCII
+    // characters, so that queries in order along such a line only count the
+    // code points in between.
+    mutable std::size_t columnLine = ~std::size_t{0};
+    mutable std::uint32_t columnOffset = 0;
+    mutable std::uint32_t columnNumber = 0;
+
+    // Computes lineOffsets, if that did not happen yet.
+    void computeLineOffsets() const;
+
+    // Returns the index in lineOffsets of the line containing offset.
+    std::size_t findLine(std::uint32_t offset) const;
+
+    // Returns the column of offset, which is on the given line.
+    std::uint32_t getColumn(std::size_t line, std::uint32_t offset) const;
+};
+
+#endif /* end of include guard: SOURCEMANAGER_HPP */
@@ -0,0 +1,134 @@
+#ifndef THREADEDLEXER_HPP
+#define THREADEDLEXER_HPP
+
+#include "lexer/diagnosticengine.hpp"
+#include "lexer/lexer.hpp"
+#include "lexer/token.hpp"
+#include "lexer/tokensource.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Lexes on a separate thread, so that lexing overlaps with whatever consumes
+// the tokens (e.g. the parser).
+//
+// The lexer thread hands the tokens over in batches, through a ring buffer of
+// at most queueSize batches. When the buffer is full, the lexer sleeps until
+// the consumer takes a batch, so only a bounded number of tokens is ever in
+// memory. When it is empty, the consumer sleeps until the lexer adds one.
+// Only handing over a batch takes the lock, so its cost is spread over
+// batchSize tokens.
+//
+// The tokens and errors come out exactly like those of a Lexer that reports to
+// the same DiagnosticEngine: errors are reported from next(), just before the
+// token they precede, and lexing stops at the error limit.
+//
+// NOTE: The identifier handles in the tokens refer to the IdentifierTable of
+// the ThreadedLexer, so the parser, which keeps them in the AST, must not let
+// the AST outlive it.
+class ThreadedLexer final : public TokenSource {
+  public:
+    static constexpr std::size_t defaultBatchSize = 1024;
+    static constexpr std::size_t defaultQueueSize = 4;
+
+    // NOTE: Like the Lexer, this does not copy the input, so the buffer must
+    // outlive both the lexer and the tokens it produces.
+    ThreadedLexer(std::string_view input, DiagnosticEngine &diagnostics,
+                  std::size_t batchSize = defaultBatchSize,
+                  std::size_t queueSize = defaultQueueSize);
+
+    // Stops the lexer thread, if it is still running.
+    ~ThreadedLexer();
+
+    ThreadedLexer(const ThreadedLexer &) = delete;
+    ThreadedLexer &operator=(const ThreadedLexer &) = delete;
+
+    std::optional<Token> next() override;
+
+    bool hadError() const override;
+
+    // Returns the table with the interned spellings of all identifiers. It is
+    // only complete once next() has returned std::nullopt; before that, the
+    // lexer thread is still adding to it.
+    const IdentifierTable &getIdentifierTable() const;
+
+  private:
+    // Tokens that are handed over at once, with the errors that were reported
+    // while lexing them.
+    struct Batch {
+        std::vector<Token> tokens;
+
+        // The errors, each with the index of the token it precedes.
+        std::vector<std::pair<std::size_t, Lexer::Error>> errors;
+
+        // Set on the last batch of the input.
+        bool last = false;
+    };
+
+    std::size_t batchSize;
+
+    // Only used on the lexer thread, until it stops.
+    Lexer lexer;
+
+    // Receives the errors. Only used on the consumer's thread.
+    DiagnosticEngine &diagnostics;
+
+    // Ring buffer with the batches that are ready. Batch i is in slot
+    // i % queue.size(). Only the lexer thread adds batches (and increments
+    // sent), and only the consumer takes them (and increments received).
+    std::vector<Batch> queue;
+    std::size_t sent = 0;
+    std::size_t received = 0;
+
+    // Set when the consumer stops, so that the lexer thread stops as well.
+    bool stopping = false;
+
+    // Guards queue, sent, received and stopping. Both sides wait on changed,
+    // which is notified whenever one of the counters or stopping changes.
+    // Only one side can be waiting at a time, since the queue cannot be full
+    // and empty at once.
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    // The batch that the consumer takes tokens from, and the position in it.
+    Batch current;
+    std::size_t nextToken = 0;
+    std::size_t nextError = 0;
+
+    // Beginning of the run of characters of the last error that was reported.
+    const char *lastRunBegin = nullptr;
+
+    // Set once next() has returned std::nullopt.
+    bool finished = false;
+
+    // Flag that is set when an error occurs.
+    bool errorFlag = false;
+
+    std::thread thread;
+
+    // Lexes the input, and hands the tokens over in batches. Runs on thread.
+    void produce();
+
+    // Adds a full batch to the queue, sleeping until there is room if needed,
+    // and leaves batch empty. Returns false if the consumer stopped.
+    bool send(Batch &batch);
+
+    // Replaces current by the next batch in the queue, sleeping until it is
+    // there if needed.
+    void receive();
+
+    // Sleeps on changed until ready() returns true. lock must hold mutex.
+    template <typename Predicate>
+    void wait(std::unique_lock<std::mutex> &lock, Predicate ready);
+
+    // Stops the lexer thread and waits for it.
+    void stop();
+};
+
+#endif /* end of include guard: THREADEDLEXER_HPP */
@@ -0,0 +1,165 @@
+#include "lexer/tokenbuffer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace {
+
+// Replaces the elements in [first, last) of v by those of replacement.
+template <typename T>
+void replaceRange(std::vector<T> &v, std::size_t first, std::size_t last,
+                  const std::vector<T> &replacement) {
+    std::size_t common = std::min(last - first, replacement.size());
+
+    std::copy_n(replacement.begin(), common, v.begin() + first);
+
+    if (common < replacement.size())
+        v.insert(v.begin() + last, replacement.begin() + common,
+                 replacement.end());
+    else
+        v.erase(v.begin() + first + common, v.begin() + last);
+}
+
+// Returns the data of a token that depends on its type, as 32 bits.
+std::uint32_t encodeData(const Token &token) {
+    switch (token.type) {
+    case TokenType::IDENTIFIER:
+        return token.identifier.id;
+    case TokenType::INT_LITERAL:
+        return static_cast<std::uint32_t>(token.intValue);
+    case TokenType::FLOAT_LITERAL: {
+        std::uint32_t bits;
+        std::memcpy(&bits, &token.floatValue, sizeof(bits));
+        return bits;
+    }
+    default:
+        return 0;
+    }
+}
+
+// Restores the data of a token that was returned by encodeData().
+void decodeData(Token &token, std::uint32_t data) {
+    switch (token.type) {
+    case TokenType::IDENTIFIER:
+        token.identifier = Identifier{data};
+        break;
+    case TokenType::INT_LITERAL:
+        token.intValue = static_cast<std::int32_t>(data);
+        break;
+    case TokenType::FLOAT_LITERAL:
+        std::memcpy(&token.floatValue, &data, sizeof(data));
+        break;
+    default:
+        break;
+    }
+}
+
+} // namespace
+
+TokenBuffer::TokenBuffer(std::string_view source) : source(source) {}
+
+void TokenBuffer::push_back(const Token &token) {
+    assert(token.lexeme.data() >= source.data() &&
+           token.lexeme.data() + token.lexeme.size() <=
+               source.data() + source.size() &&
+           "Token does not point into the source buffer!");
+
+    types.push_back(static_cast<std::uint8_t>(token.type));
+    offsets.push_back(
+        static_cast<std::uint32_t>(token.lexeme.data() - source.data()));
+    lengths.push_back(static_cast<std::uint32_t>(token.lexeme.size()));
+    data.push_back(encodeData(token));
+}
+
+void TokenBuffer::append(const TokenBuffer &other, std::size_t from) {
+    assert(source.data() == other.source.data() &&
+           source.size() == other.source.size() &&
+           "Buffers refer to a different source!");
+
+    types.insert(types.end(), other.types.begin() + from, other.types.end());
+    offsets.insert(offsets.end(), other.offsets.begin() + from,
+                   other.offsets.end());
+    lengths.insert(lengths.end(), other.lengths.begin() + from,
+                   other.lengths.end());
+    data.insert(data.end(), other.data.begin() + from, other.data.end());
+}
+
+void TokenBuffer::replace(std::size_t first, std::size_t last,
+                          const TokenBuffer &other, std::int64_t delta) {
+    assert(first <= last && last <= size() && "Invalid range!");
+
+    replaceRange(types, first, last, other.types);
+    replaceRange(offsets, first, last, other.offsets);
+    replaceRange(lengths, first, last, other.lengths);
+    replaceRange(data, first, last, other.data);
+
+    for (std::size_t i = first + other.size(); i < offsets.size(); ++i)
+        offsets[i] = static_cast<std::uint32_t>(offsets[i] + delta);
+
+    source = other.source;
+}
+
+void TokenBuffer::reserve(std::size_t count) {
+    types.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+    data.reserve(count);
+}
+
+void TokenBuffer::truncate(std::size_t count) {
+    assert(count <= size() && "Cannot truncate to a larger size!");
+
+    types.resize(count);
+    offsets.resize(count);
+    lengths.resize(count);
+    data.resize(count);
+}
+
+std::size_t TokenBuffer::size() const { return types.size(); }
+
+bool TokenBuffer::empty() const { return types.empty(); }
+
+Token TokenBuffer::operator[](std::size_t index) const {
+    return makeToken(getType(index),
+                     source.substr(getOffset(index), getLength(index)),
+                     data[index]);
+}
+
+TokenType TokenBuffer::getType(std::size_t index) const {
+    return static_cast<TokenType>(types[index]);
+}
+
+std::uint32_t TokenBuffer::getOffset(std::size_t index) const {
+    return offsets[index];
+}
+
+std::uint32_t TokenBuffer::getLength(std::size_t index) const {
+    return lengths[index];
+}
+
+Identifier TokenBuffer::getIdentifier(std::size_t index) const {
+    assert(getType(index) == TokenType::IDENTIFIER && "Not an identifier!");
+
+    return Identifier{data[index]};
+}
+
+std::uint32_t TokenBuffer::getData(std::size_t index) const {
+    return data[index];
+}
+
+void TokenBuffer::setIdentifier(std::size_t index, Identifier identifier) {
+    assert(getType(index) == TokenType::IDENTIFIER && "Not an identifier!");
+
+    data[index] = identifier.id;
+}
+
+std::string_view TokenBuffer::getSource() const { return source; }
+
+Token TokenBuffer::makeToken(TokenType type, std::string_view lexeme,
+                             std::uint32_t data) {
+    Token token(type, lexeme);
+    decodeData(token, data);
+
+    return token;
+}
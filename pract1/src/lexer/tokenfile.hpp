@@ -0,0 +1,99 @@
+#ifndef TOKENFILE_HPP
+#define TOKENFILE_HPP
+
+#include "lexer/identifiertable.hpp"
+#include "lexer/token.hpp"
+#include "lexer/tokenbuffer.hpp"
+#include "lexer/tokensource.hpp"
+
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// A lexed token stream in the binary .mctok format, so that the tokens of a
+// file can be cached, or read by other tools, without running the lexer.
+//
+// A token file is self-contained: it holds the source, the tokens in the
+// layout of a TokenBuffer (types, offsets, lengths and the identifier or
+// decoded literal value) and the spellings of the interned identifiers. All
+// numbers are little-endian, and every section is at a fixed position that
+// follows from the header, so the file can be memory-mapped and used in
+// place. TokenFile is such a view; it does not copy anything.
+//
+// Layout, with each section padded to a multiple of 4 bytes:
+//
+//   Header
+//   char     source[sourceSize]
+//   uint8_t  types[tokenCount]
+//   uint32_t offsets[tokenCount]
+//   uint32_t lengths[tokenCount]
+//   uint32_t data[tokenCount]
+//   uint32_t spellingOffsets[identifierCount + 1]
+//   char     spellings[spellingSize]
+//
+// The types are the values of TokenType, so any change to TokenType requires
+// a new version.
+class TokenFile final : public TokenSource {
+  public:
+    static constexpr std::uint32_t version = 1;
+
+    // Returns true if buffer starts like a token file.
+    static bool isTokenFile(std::string_view buffer);
+
+    // Writes tokens, whose identifiers are interned in identifiers, as a token
+    // file.
+    static void write(llvm::raw_ostream &out, const TokenBuffer &tokens,
+                      const IdentifierTable &identifiers);
+
+    // Checks that buffer is a valid token file of this version, and returns a
+    // view of it. The buffer must outlive the view and the tokens it returns.
+    static llvm::Expected<TokenFile> read(std::string_view buffer);
+
+    // Returns the tokens in order, starting at the first.
+    std::optional<Token> next() override;
+
+    // Token files are only written for sources without errors.
+    bool hadError() const override;
+
+    std::size_t size() const;
+
+    // Returns the token at the given index. Its lexeme points into the source
+    // in the file.
+    Token operator[](std::size_t index) const;
+
+    // Returns the source that the tokens were lexed from.
+    std::string_view getSource() const;
+
+    // Returns the number of distinct identifiers.
+    std::size_t getIdentifierCount() const;
+
+    // Returns the spelling of an identifier of one of the tokens.
+    std::string_view getSpelling(Identifier identifier) const;
+
+  private:
+    using ulittle32_t = llvm::support::ulittle32_t;
+
+    TokenFile() = default;
+
+    std::string_view source;
+
+    std::size_t tokenCount = 0;
+    const std::uint8_t *types = nullptr;
+    const ulittle32_t *offsets = nullptr;
+    const ulittle32_t *lengths = nullptr;
+    const ulittle32_t *data = nullptr;
+
+    std::size_t identifierCount = 0;
+    const ulittle32_t *spellingOffsets = nullptr;
+    const char *spellings = nullptr;
+
+    // Index of the token that next() returns.
+    std::size_t position = 0;
+};
+
+#endif /* end of include guard: TOKENFILE_HPP */
@@ -0,0 +1,20 @@
+#ifndef TOKENSOURCE_HPP
+#define TOKENSOURCE_HPP
+
+#include "lexer/token.hpp"
+
+#include <optional>
+
+// A stream of tokens, e.g. a Lexer, or the tokens stored in a TokenFile.
+class TokenSource {
+  public:
+    virtual ~TokenSource() = default;
+
+    // Returns the next token, or std::nullopt at the end of the stream.
+    virtual std::optional<Token> next() = 0;
+
+    // Returns true if an error occurred while producing the tokens.
+    virtual bool hadError() const = 0;
+};
+
+#endif /* end of include guard: TOKENSOURCE_HPP */
@@ -0,0 +1,33 @@
+#ifndef UTF8_HPP
+#define UTF8_HPP
+
+#include <cstddef>
+
+// Validation of UTF-8 text, for the parts of the source that may contain
+// multibyte characters (comments and string literals).
+//
+// A sequence is valid if it is the shortest encoding of a code point up to
+// U+10FFFF that is not a surrogate, i.e. what RFC 3629 allows.
+namespace utf8 {
+
+inline bool isContinuation(char c) { return (c & 0xC0) == 0x80; }
+
+// Returns the length of the valid sequence that starts at p, or 0 if the
+// bytes at p do not form one. [p, end) must not be empty.
+std::size_t sequenceLength(const char *p, const char *end);
+
+// Returns the length of the invalid sequence that starts at p: the first byte
+// and any continuation bytes after it. [p, end) must not be empty.
+std::size_t invalidLength(const char *p, const char *end);
+
+// Returns a pointer to the first invalid sequence in [p, end), or end if the
+// text is valid. Runs of ASCII are skipped a whole vector at a time.
+const char *findInvalid(const char *p, const char *end);
+
+// Returns the number of characters in [p, end): every valid sequence is one
+// character, and so is every byte that is not part of one.
+std::size_t countCharacters(const char *p, const char *end);
+
+} // namespace utf8
+
+#endif /* end of include guard: UTF8_HPP */
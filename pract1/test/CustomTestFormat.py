@@ -8,7 +8,7 @@ class CustomTestFormat(lit.formats.ShTest):
 
         full_test_path = Path(test.suite.source_root, *test.path_in_suite)
 
-        with full_test_path.open("r") as f:
+        with full_test_path.open("r", errors="replace") as f:
             m = re.search(r"RUN-WITH-ARGS: (.*)", f.readline())
         
         extra_args = ""
@@ -0,0 +1,2 @@
+// A gzip member whose compressed data is damaged.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.gz
@@ -0,0 +1,3 @@
+// A zstd frame whose compressed data is damaged.
+// REQUIRES: zstd
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.zst
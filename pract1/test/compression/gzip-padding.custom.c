@@ -0,0 +1,4 @@
+// Like gzip, zeros after the last member are ignored.
+// RUN: %diff-command-output.sh %s %t -- %microcc %s
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.gz
+int padded;
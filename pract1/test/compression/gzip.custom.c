@@ -0,0 +1,8 @@
+// Gzip-compressed input gives the same tokens as the source itself.
+// RUN: %diff-command-output.sh %s %t -- %microcc %s
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.gz
+int main()
+{
+    float x = 1.5;
+    return x >= 2 != (x == 3);
+}
@@ -0,0 +1,2 @@
+// A gzip member that ends in the middle of the compressed data.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.gz
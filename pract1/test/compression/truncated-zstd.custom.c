@@ -0,0 +1,3 @@
+// A zstd frame that ends in the middle of the compressed data.
+// REQUIRES: zstd
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.zst
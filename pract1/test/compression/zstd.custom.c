@@ -0,0 +1,9 @@
+// Zstd-compressed input gives the same tokens as the source itself.
+// REQUIRES: zstd
+// RUN: %diff-command-output.sh %s %t -- %microcc %s
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.zst
+int main()
+{
+    float x = 1.5;
+    return x >= 2 != (x == 3);
+}
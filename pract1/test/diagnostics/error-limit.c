@@ -0,0 +1,5 @@
+// RUN-WITH-ARGS: -ferror-limit=2
+int a = 1.2.3;
+int b = @;
+int c = !;
+int d = #;
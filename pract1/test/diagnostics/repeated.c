@@ -0,0 +1,3 @@
+int a = @@@@@;
+int b = @;
+int c = 1.2.3;
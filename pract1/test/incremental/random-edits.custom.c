@@ -0,0 +1,18 @@
+// Applies random edits with the IncrementalLexer, and checks the tokens and
+// errors after every edit against those of a fresh lexer.
+// RUN: %microcc-incremental-lexer-bench -verify -n 300 %s > /dev/null
+int main()
+{
+    /* A block comment
+       over two lines. */
+    int x = 42;
+    float y = 1.5;
+    char *s = "a string // with a comment";
+    while (x != 0) {
+        x = x - 1;
+        y = y * 2.0;
+    }
+    if (x == 0 && !y)
+        return @;
+    return x <= 1 || y >= 2;
+}
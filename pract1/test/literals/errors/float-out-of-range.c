@@ -0,0 +1,2 @@
+3.5
+999999999999999999999999999999999999999999.0
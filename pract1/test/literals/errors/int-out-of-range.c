@@ -0,0 +1,2 @@
+2147483647
+2147483648
@@ -16,7 +16,7 @@ EOF
 }
 
 positional=()
-microcc_args=("")
+microcc_args=()
 
 while [[ $# -gt 0 ]]; do
     case $1 in
@@ -45,4 +45,4 @@ fi
 MICROCC_PATH=$1
 INPUT_FILE=$2
 
-$MICROCC_PATH $microcc_args <(awk '/^\/\/ RUN:/ || /^\/\/ CHECK/ { printf "%s", RT; next } { printf "%s%s", $0, RT }' $INPUT_FILE)
+$MICROCC_PATH "${microcc_args[@]}" <(awk '/^\/\/ RUN:/ || /^\/\/ CHECK/ { printf "%s", RT; next } { printf "%s%s", $0, RT }' $INPUT_FILE)
@@ -0,0 +1,9 @@
+// With an error limit, the parallel lexer stops at the same token as the
+// sequential one, so the tokens after the limit are not dumped.
+// RUN: %diff-command-output.sh %s %t -- %microcc %s -j=2 -lex-chunk-size=4 -ferror-limit=1
+// RUN: %microcc %s -j=2 -lex-chunk-size=4 -ferror-limit=1 > %t.tokens || true
+// RUN: diff %t.tokens %s.stdout
+int a = @;
+int b = #;
+int c = $;
+int d;
@@ -0,0 +1,6 @@
+// RUN-WITH-ARGS: -j=3 -lex-chunk-size=16
+int a = 1.2.3;
+int b = @;
+char s = "unterminated
+int c = !;
+int d = 4;
@@ -0,0 +1,15 @@
+// RUN-WITH-ARGS: -j=3 -lex-chunk-size=16
+int counter;
+
+
+float average(int values[10], int count) {
+    // Chunks end just after a newline, but runs of whitespace cross them.
+    int i = 0;
+    float sum = 0.0;
+    while (i < count) {
+        sum = sum + values[i];
+        i = i + 1;
+    }
+    print("a string literal that is longer than a chunk");
+    return sum / count;
+}
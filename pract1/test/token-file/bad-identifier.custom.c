@@ -0,0 +1,2 @@
+// A token file with an identifier that is not in the identifier table.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.mctok
@@ -0,0 +1,2 @@
+// A token file whose spelling offsets decrease.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.mctok
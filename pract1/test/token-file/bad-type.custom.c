@@ -0,0 +1,2 @@
+// A token file with a token type that does not exist.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.mctok
@@ -0,0 +1,2 @@
+// A token file of an unsupported version.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.mctok
@@ -0,0 +1,16 @@
+// The tokens of a token file are printed like those of the source itself.
+// RUN: %diff-command-output.sh %s %t -- %microcc %s
+// RUN: %microcc %s -emit-tokens=%t.mctok
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary %t.mctok
+int sum(int n)
+{
+    int total = 0;
+    while (n > 0) {
+        total = total + n;
+        n = n - 1;
+    }
+    return total;
+}
+
+float scale = 2.5;
+char name[8] = "micro";
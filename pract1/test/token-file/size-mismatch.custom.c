@@ -0,0 +1,2 @@
+// A token file that is larger than its header says.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.mctok
@@ -0,0 +1,2 @@
+// A token file with a token that extends past the end of the source.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.mctok
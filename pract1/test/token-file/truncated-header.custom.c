@@ -0,0 +1,2 @@
+// A token file that ends in the middle of its header.
+// RUN: %diff-command-output.sh %s %t -- %microcc-binary - < %s.mctok
@@ -0,0 +1,3 @@
+int é = 1;
+int x = 2 × 3;
+int y = 4;
@@ -0,0 +1,8 @@
+// Invalid UTF-8 in comments, string literals and between tokens.
+// bad  byte
+int a = @;
+char s = "caf and";
+int b = @;
+char t = "";
+int c = ;
+char u = "ok é ";
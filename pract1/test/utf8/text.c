@@ -0,0 +1,3 @@
+// Grüße, 世界 😀
+char s = "héllo wörld"; int x;
+print("→ ✓", x);
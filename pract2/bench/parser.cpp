@@ -0,0 +1,162 @@
+// Throughput benchmark for the parser on synthetic MicroC sources.
+//
+// Generates functions that either only contain declarations, or contain
+// statements of which a given percentage has a syntax error. Parses them
+// (lexing included) into an ASTContext, and reports the parse time, nodes/s,
+// the memory of the AST and the time to free it. Use -dump to write the
+// generated source to stdout instead.
+
+#include "ast/astcontext.hpp"
+#include "lexer/diagnosticengine.hpp"
+#include "lexer/lexer.hpp"
+#include "parser/parser.hpp"
+
+#include "llvm/Support/CommandLine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <memory>
+#include <random>
+#include <string>
+
+enum class Mix { Declarations, Statements };
+
+llvm::cl::opt<Mix> FunctionMix(
+    "mix", llvm::cl::desc("Kind of functions to generate"),
+    llvm::cl::values(
+        clEnumValN(Mix::Declarations, "declarations",
+                   "Declarations and nested blocks only"),
+        clEnumValN(Mix::Statements, "statements",
+                   "Expressions, calls, loops and conditionals")),
+    llvm::cl::init(Mix::Statements));
+
+llvm::cl::opt<unsigned>
+    NumFunctions("functions", llvm::cl::desc("Number of functions"),
+                 llvm::cl::init(40000));
+
+llvm::cl::opt<unsigned> ErrorPercentage(
+    "errors",
+    llvm::cl::desc("Percentage of statements with a syntax error"),
+    llvm::cl::init(0));
+
+llvm::cl::opt<unsigned> Seed("seed",
+                             llvm::cl::desc("Seed for the generator"),
+                             llvm::cl::init(42));
+
+llvm::cl::opt<unsigned>
+    Repetitions("repeat",
+                llvm::cl::desc("Number of runs, of which the fastest counts"),
+                llvm::cl::init(3));
+
+llvm::cl::opt<bool>
+    Dump("dump", llvm::cl::desc("Print the generated source and exit"));
+
+// Generates MicroC functions.
+class Generator {
+  public:
+    Generator(unsigned seed) : rng(seed) {}
+
+    void appendFunction(std::string &out, unsigned index, Mix mix) {
+        switch (mix) {
+        case Mix::Declarations:
+            out += fmt::format("int f{}(int a, float b) {{ int x; float "
+                               "y[10]; ; {{ int z; {{ ; }} }} int w[3]; }}\n",
+                               index);
+            break;
+        case Mix::Statements:
+            out += fmt::format("int f{}(int a, int b)\n{{\n", index);
+            for (unsigned i = 0; i < 12; ++i) {
+                out += "    ";
+                out += pick(100) < ErrorPercentage ? pick(bad) : pick(good);
+                out += '\n';
+            }
+            out += "}\n";
+            break;
+        }
+    }
+
+  private:
+    std::mt19937 rng;
+
+    static constexpr const char *good[] = {
+        "x = a + b * (c - 4) ^ 2;",
+        "int y = f(a, b[3], 2.5);",
+        "while (a < b) { a = a + 1; }",
+        "if (a == b) { return a; } else { c = -d; }",
+        "return a * b % c;",
+    };
+
+    static constexpr const char *bad[] = {
+        "x = a + ;",
+        "int y = f(a, , 2);",
+        "while (a < b { a = 1; }",
+        "if (a == b == c) return a;",
+        "x = (a + b;",
+        "int int z;",
+        "return a b;",
+    };
+
+    std::size_t pick(std::size_t n) {
+        return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng);
+    }
+
+    template <std::size_t N> const char *pick(const char *const (&list)[N]) {
+        return list[pick(N)];
+    }
+};
+
+int main(int argc, char *argv[]) {
+    llvm::cl::ParseCommandLineOptions(argc, argv);
+
+    std::string input;
+
+    Generator generator{Seed};
+    for (unsigned i = 0; i < NumFunctions; ++i)
+        generator.appendFunction(input, i, FunctionMix);
+
+    if (Dump) {
+        fmt::print("{}", input);
+        return EXIT_SUCCESS;
+    }
+
+    double best = 0;
+    double freeTime = 0;
+    unsigned nodeCount = 0;
+    std::size_t memory = 0;
+    bool hadError = false;
+
+    for (unsigned i = 0; i < Repetitions; ++i) {
+        DiagnosticEngine diagnostics{0};
+        Lexer lexer{input, diagnostics};
+        auto context = std::make_unique<ast::ASTContext>();
+
+        auto start = std::chrono::steady_clock::now();
+        Parser parser{lexer, diagnostics, *context};
+        parser.parse();
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        nodeCount = context->getNextId();
+        memory = context->getMemoryUsage();
+        hadError = diagnostics.hadError();
+
+        start = std::chrono::steady_clock::now();
+        context.reset();
+        std::chrono::duration<double> freed =
+            std::chrono::steady_clock::now() - start;
+
+        if (i == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+            freeTime = freed.count();
+        }
+    }
+
+    fmt::print("{} nodes{}\n", nodeCount, hadError ? ", with errors" : "");
+    fmt::print("parse  {:10.3f} s  ({:.1f} M nodes/s)\n", best,
+               nodeCount / best / 1e6);
+    fmt::print("AST    {:10.1f} MB\n", memory / 1048576.0);
+    fmt::print("free   {:10.4f} s\n", freeTime);
+
+    return EXIT_SUCCESS;
+}
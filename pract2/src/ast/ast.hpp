@@ -3,17 +3,18 @@
 
 #include "lexer/token.hpp"
 
-#include <memory>
-#include <vector>
+#include "llvm/ADT/ArrayRef.h"
+
+#include <string_view>
 
 namespace ast {
 
-template <typename T> using List = std::vector<T>;
+// NOTE: Nodes and their lists are owned by an ASTContext (see
+// ast/astcontext.hpp), which frees them all at once. So pointers to nodes, and
+// lists of children, are non-owning and can be copied freely.
+template <typename T> using List = llvm::ArrayRef<T>;
 
-// NOTE: Using std::unique_ptr<T> instead of std::shared_ptr<T> is more correct,
-// semantically speaking, but it requires std::move's everywhere, so let's not
-// do it for now.
-template <typename T> using Ptr = std::shared_ptr<T>;
+template <typename T> using Ptr = T *;
 
 // Base class
 struct Base {
@@ -38,12 +39,11 @@ struct Base {
         FuncCallExpr
     } kind;
 
-    unsigned int id;
+    // Numbers the nodes in order of creation. Assigned by the ASTContext that
+    // creates the node.
+    unsigned int id = 0;
 
-    Base(Kind kind) : kind(kind) {
-        static int next_id = 0;
-        id = next_id++;
-    }
+    Base(Kind kind) : kind(kind) {}
 };
 
 // Forward declarations
@@ -58,7 +58,7 @@ struct CompoundStmt;
 struct Program : public Base {
     List<Ptr<FuncDecl>> declarations;
 
-    Program(const List<Ptr<FuncDecl>> &declarations)
+    Program(List<Ptr<FuncDecl>> declarations)
         : Base(Kind::Program), declarations(declarations) {}
 };
 
@@ -69,9 +69,9 @@ struct FuncDecl : public Base {
     Ptr<CompoundStmt> body;
 
     FuncDecl(const Token &returnType, const Token &name,
-             const List<Ptr<VarDecl>> &arguments, Ptr<CompoundStmt> body)
+             List<Ptr<VarDecl>> arguments, Ptr<CompoundStmt> body)
         : Base(Kind::FuncDecl), returnType(returnType), name(name),
-          arguments(arguments), body(std::move(body)) {}
+          arguments(arguments), body(body) {}
 };
 
 // Statements
@@ -90,9 +90,8 @@ struct IfStmt : public Stmt {
 
     IfStmt(Ptr<Expr> condition, Ptr<Stmt> if_clause,
            Ptr<Stmt> else_clause = nullptr)
-        : Stmt(Kind::IfStmt), condition(std::move(condition)),
-          if_clause(std::move(if_clause)), else_clause(std::move(else_clause)) {
-    }
+        : Stmt(Kind::IfStmt), condition(condition), if_clause(if_clause),
+          else_clause(else_clause) {}
 };
 
 struct WhileStmt : public Stmt {
@@ -100,21 +99,20 @@ struct WhileStmt : public Stmt {
     Ptr<Stmt> body;
 
     WhileStmt(Ptr<Expr> condition, Ptr<Stmt> body)
-        : Stmt(Kind::WhileStmt), condition(std::move(condition)),
-          body(std::move(body)) {}
+        : Stmt(Kind::WhileStmt), condition(condition), body(body) {}
 };
 
 struct ReturnStmt : public Stmt {
     Ptr<Expr> value;
 
     ReturnStmt(Ptr<Expr> value = nullptr)
-        : Stmt(Kind::ReturnStmt), value(std::move(value)) {}
+        : Stmt(Kind::ReturnStmt), value(value) {}
 };
 
 struct ExprStmt : public Stmt {
     Ptr<Expr> expr;
 
-    ExprStmt(Ptr<Expr> expr) : Stmt(Kind::ExprStmt), expr(std::move(expr)) {}
+    ExprStmt(Ptr<Expr> expr) : Stmt(Kind::ExprStmt), expr(expr) {}
 };
 
 struct VarDecl : public Stmt {
@@ -123,7 +121,7 @@ struct VarDecl : public Stmt {
     Ptr<Expr> init;
 
     VarDecl(const Token &type, const Token &name, Ptr<Expr> init = nullptr)
-        : Stmt(Kind::VarDecl), type(type), name(name), init(std::move(init)) {}
+        : Stmt(Kind::VarDecl), type(type), name(name), init(init) {}
 };
 
 struct ArrayDecl : public Stmt {
@@ -132,15 +130,13 @@ struct ArrayDecl : public Stmt {
     Ptr<IntLiteral> size;
 
     ArrayDecl(const Token &type, const Token &name, Ptr<IntLiteral> size)
-        : Stmt(Kind::ArrayDecl), type(type), name(name), size(std::move(size)) {
-    }
+        : Stmt(Kind::ArrayDecl), type(type), name(name), size(size) {}
 };
 
 struct CompoundStmt : public Stmt {
     List<Ptr<Stmt>> body;
 
-    CompoundStmt(const List<Ptr<Stmt>> &body)
-        : Stmt(Kind::CompoundStmt), body(body) {}
+    CompoundStmt(List<Ptr<Stmt>> body) : Stmt(Kind::CompoundStmt), body(body) {}
 };
 
 // Expressions
@@ -154,8 +150,7 @@ struct BinaryOpExpr : public Expr {
     Ptr<Expr> rhs;
 
     BinaryOpExpr(Ptr<Expr> lhs, const Token &op, Ptr<Expr> rhs)
-        : Expr(Kind::BinaryOpExpr), lhs(std::move(lhs)), op(op),
-          rhs(std::move(rhs)) {}
+        : Expr(Kind::BinaryOpExpr), lhs(lhs), op(op), rhs(rhs) {}
 };
 
 struct UnaryOpExpr : public Expr {
@@ -163,7 +158,7 @@ struct UnaryOpExpr : public Expr {
     Ptr<Expr> operand;
 
     UnaryOpExpr(const Token &op, Ptr<Expr> operand)
-        : Expr(Kind::UnaryOpExpr), op(op), operand(std::move(operand)) {}
+        : Expr(Kind::UnaryOpExpr), op(op), operand(operand) {}
 };
 
 struct IntLiteral : public Expr {
@@ -179,9 +174,9 @@ struct FloatLiteral : public Expr {
 };
 
 struct StringLiteral : public Expr {
-    std::string value;
+    std::string_view value;
 
-    StringLiteral(const std::string &value)
+    StringLiteral(std::string_view value)
         : Expr(Kind::StringLiteral), value(value) {}
 };
 
@@ -196,14 +191,14 @@ struct ArrayRefExpr : public Expr {
     Ptr<Expr> index;
 
     ArrayRefExpr(const Token &name, Ptr<Expr> index)
-        : Expr(Kind::ArrayRefExpr), name(name), index(std::move(index)) {}
+        : Expr(Kind::ArrayRefExpr), name(name), index(index) {}
 };
 
 struct FuncCallExpr : public Expr {
     Token name;
     List<Ptr<Expr>> arguments;
 
-    FuncCallExpr(const Token &name, const List<Ptr<Expr>> &arguments)
+    FuncCallExpr(const Token &name, List<Ptr<Expr>> arguments)
         : Expr(Kind::FuncCallExpr), name(name), arguments(arguments) {}
 };
 
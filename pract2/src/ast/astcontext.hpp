@@ -0,0 +1,98 @@
+#ifndef AST_ASTCONTEXT_HPP
+#define AST_ASTCONTEXT_HPP
+
+#include "ast/ast.hpp"
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Allocator.h"
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ast {
+
+// Owns the nodes of an AST, and the lists they refer to.
+//
+// Everything is allocated in a bump-pointer arena, so creating a node is
+// little more than a pointer increment, and the whole tree is freed at once
+// when the context is destroyed. No destructors are run, so nodes may only
+// contain trivially destructible members. The context must outlive every
+// pointer to its nodes.
+//
+// The context also numbers the nodes (Base::id) in the order they are created,
+// starting at 0.
+class ASTContext {
+  public:
+    ASTContext() = default;
+
+    ASTContext(const ASTContext &) = delete;
+    ASTContext &operator=(const ASTContext &) = delete;
+
+    // Creates a node of type T from the given constructor arguments.
+    template <typename T, typename... Args> Ptr<T> create(Args &&...args) {
+        static_assert(std::is_base_of_v<Base, T>, "Not an AST node!");
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "AST nodes are never destroyed!");
+
+        T *node = new (allocator.Allocate<T>()) T(std::forward<Args>(args)...);
+        node->id = nextId++;
+
+        return node;
+    }
+
+    // Copies the given elements into the arena, e.g. the children of a node
+    // that were collected in a temporary vector.
+    template <typename T> List<T> createList(llvm::ArrayRef<T> elements) {
+        static_assert(std::is_trivially_destructible_v<T>,
+                      "List elements are never destroyed!");
+
+        if (elements.empty())
+            return {};
+
+        T *data = allocator.Allocate<T>(elements.size());
+        std::uninitialized_copy(elements.begin(), elements.end(), data);
+
+        return List<T>(data, elements.size());
+    }
+
+    // Takes over the nodes of other, e.g. a part of the AST that was parsed on
+    // another thread, so that they live as long as this context. Their ids are
+    // left alone (see reserveIds()).
+    void adopt(ASTContext &&other) {
+        adopted.push_back(std::move(other.allocator));
+        for (llvm::BumpPtrAllocator &allocator : other.adopted)
+            adopted.push_back(std::move(allocator));
+        other.adopted.clear();
+    }
+
+    // Returns the id of the next node that is created.
+    unsigned getNextId() const { return nextId; }
+
+    // Skips the next count ids, e.g. when nodes from another context are
+    // renumbered to follow the nodes of this one.
+    void reserveIds(unsigned count) { nextId += count; }
+
+    // Returns the number of bytes allocated for the AST.
+    std::size_t getMemoryUsage() const {
+        std::size_t usage = allocator.getTotalMemory();
+        for (const llvm::BumpPtrAllocator &allocator : adopted)
+            usage += allocator.getTotalMemory();
+
+        return usage;
+    }
+
+  private:
+    llvm::BumpPtrAllocator allocator;
+
+    // The arenas of the contexts that were adopted.
+    std::vector<llvm::BumpPtrAllocator> adopted;
+
+    unsigned nextId = 0;
+};
+
+} // namespace ast
+
+#endif /* end of include guard: AST_ASTCONTEXT_HPP */
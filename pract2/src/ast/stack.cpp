@@ -0,0 +1,55 @@
+#include "ast/stack.hpp"
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/Support/thread.h"
+
+#include <cstddef>
+
+namespace {
+
+// Size of the stacks of the threads that runOnNewStack() creates.
+constexpr unsigned newStackSize = 8 << 20;
+
+// Size that is assumed for the stacks of other threads, e.g. the main thread.
+// Most are larger, but then a new stack is merely created a bit early.
+constexpr std::size_t defaultStackSize = 1 << 20;
+
+// Room that is left for the functions that run between two checks, e.g. the
+// parsing functions of one level of nesting.
+constexpr std::size_t sufficientStackSpace = 256 << 10;
+
+// The bottom of the stack of the current thread, and its size.
+thread_local const char *bottom = nullptr;
+thread_local std::size_t size = defaultStackSize;
+
+const char *getStackPointer() {
+    return static_cast<const char *>(__builtin_frame_address(0));
+}
+
+} // namespace
+
+bool ast::isStackNearlyExhausted() {
+    const char *position = getStackPointer();
+
+    if (!bottom) {
+        bottom = position;
+        return false;
+    }
+
+    // The stack may grow in either direction.
+    std::size_t used =
+        position < bottom ? bottom - position : position - bottom;
+
+    return used > size - sufficientStackSpace;
+}
+
+void ast::detail::runOnNewStack(llvm::function_ref<void()> fn) {
+    llvm::thread thread(llvm::Optional<unsigned>(newStackSize), [fn] {
+        bottom = getStackPointer();
+        size = newStackSize;
+
+        fn();
+    });
+
+    thread.join();
+}
@@ -0,0 +1,48 @@
+#ifndef AST_STACK_HPP
+#define AST_STACK_HPP
+
+#include "llvm/ADT/STLExtras.h"
+
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace ast {
+
+// The parser and the visitors recurse once per level of nesting in the input,
+// so deeply nested input (e.g. generated code) would overflow the stack. To
+// prevent that, they check isStackNearlyExhausted() at every level, and
+// continue on a new stack when it returns true:
+//
+//     if (isStackNearlyExhausted())
+//         return runOnNewStack([&] { return parseStmt(); });
+//
+// A new stack is only created when the previous one is nearly full, so the
+// memory that is used stays proportional to the depth of the nesting.
+
+// Returns true if the stack of the current thread is about to run out. The
+// first call on a thread marks the bottom of its stack.
+bool isStackNearlyExhausted();
+
+namespace detail {
+void runOnNewStack(llvm::function_ref<void()> fn);
+} // namespace detail
+
+// Runs fn on a new thread, with a fresh stack, waits for it and returns its
+// result.
+template <typename Function>
+auto runOnNewStack(Function &&fn) -> decltype(fn()) {
+    using Result = decltype(fn());
+
+    if constexpr (std::is_void_v<Result>) {
+        detail::runOnNewStack(fn);
+    } else {
+        std::optional<Result> result;
+        detail::runOnNewStack([&fn, &result] { result.emplace(fn()); });
+        return std::move(*result);
+    }
+}
+
+} // namespace ast
+
+#endif /* end of include guard: AST_STACK_HPP */
@@ -2,6 +2,7 @@
 #define AST_VISITOR_HPP
 
 #include "ast/ast.hpp"
+#include "ast/stack.hpp"
 
 #include <cassert>
 
@@ -118,6 +119,10 @@ struct Visitor {
     }
 
     RetTy visit(Base &node, ArgTys... args) {
+        // Deep trees would overflow the stack, see ast/stack.hpp.
+        if (isStackNearlyExhausted())
+            return runOnNewStack([&] { return visit(node, args...); });
+
         switch (node.kind) {
         case Base::Kind::Program:
             return derived().visitProgram(static_cast<Program &>(node),
@@ -1,20 +1,32 @@
 #include "ast/ast.hpp"
+#include "ast/astcontext.hpp"
 #include "ast/prettyprinter.hpp"
+#include "lexer/compression.hpp"
+#include "lexer/diagnosticengine.hpp"
 #include "lexer/lexer.hpp"
+#include "lexer/sourcemanager.hpp"
+#include "lexer/threadedlexer.hpp"
 #include "lexer/token.hpp"
+#include "lexer/tokendumper.hpp"
+#include "lexer/tokenfile.hpp"
+#include "lexer/tokensource.hpp"
+#include "parser/parallelparser.hpp"
 #include "parser/parser.hpp"
 
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
 
+#include <cstddef>
 #include <cstdlib>
 #include <fmt/core.h>
-#include <fstream>
-#include <iomanip>
 #include <iostream>
-#include <sstream>
-#include <streambuf>
+#include <memory>
+#include <optional>
 #include <string>
-#include <vector>
+#include <string_view>
+#include <utility>
 
 llvm::cl::opt<std::string> InputFilename(llvm::cl::Positional,
                                          llvm::cl::desc("<input file>"),
@@ -25,53 +37,165 @@ llvm::cl::opt<bool>
                llvm::cl::desc("Dump tokens after lexical analysis"),
                llvm::cl::init(false));
 
+llvm::cl::opt<unsigned>
+    ErrorLimit("ferror-limit",
+               llvm::cl::desc("Stop after this many errors (0 = no limit)"),
+               llvm::cl::init(0));
+
+llvm::cl::opt<bool>
+    LexerThread("lexer-thread",
+                llvm::cl::desc("Lex on a separate thread, while parsing"),
+                llvm::cl::init(false));
+
+llvm::cl::opt<unsigned>
+    Threads("j",
+            llvm::cl::desc("Number of threads to parse with (0 = one per "
+                           "hardware thread)"),
+            llvm::cl::init(1));
+
+llvm::cl::opt<std::size_t> ChunkSize(
+    "parse-chunk-size",
+    llvm::cl::desc("Number of tokens of the chunks that are parsed in "
+                   "parallel"),
+    llvm::cl::init(ParallelParser::defaultChunkSize), llvm::cl::Hidden);
+
+llvm::cl::opt<bool>
+    SyntaxOnly("fsyntax-only",
+               llvm::cl::desc("Check the input for errors, but do not print "
+                              "the AST"),
+               llvm::cl::init(false));
+
 llvm::cl::opt<bool>
     AsciiMode("ascii-mode",
               llvm::cl::desc("Dump AST in ASCII mode instead of Unicode"),
               llvm::cl::init(false));
 
+llvm::cl::opt<bool> DumpIds("dump-ids",
+                            llvm::cl::desc("Dump the ids of the AST nodes"),
+                            llvm::cl::init(false));
+
 int main(int argc, char *argv[]) {
     // Parse command-line arguments
     llvm::cl::ParseCommandLineOptions(argc, argv);
 
-    // Convert input file/stdin to string
-    std::string inputContents;
-    if (InputFilename == "-") {
-        inputContents = std::string{std::istreambuf_iterator<char>(std::cin),
-                                    std::istreambuf_iterator<char>()};
-    } else {
-        std::ifstream inputFile{InputFilename};
-        inputContents = std::string{std::istreambuf_iterator<char>(inputFile),
-                                    std::istreambuf_iterator<char>()};
+    // Map the input file into memory, or read it if it is stdin or a pipe.
+    // The lexer, tokens and AST borrow this buffer, so it must stay alive
+    // until we are done.
+    auto inputBuffer = llvm::MemoryBuffer::getFileOrSTDIN(InputFilename);
+    if (!inputBuffer) {
+        llvm::WithColor::error(llvm::errs(), "microcc")
+            << fmt::format("{}: {}\n", InputFilename.getValue(),
+                           inputBuffer.getError().message());
+        return EXIT_FAILURE;
     }
 
-    // Phase 1: lexical analysis
-    Lexer lexer{inputContents};
-    std::vector<Token> tokens = lexer.getTokens();
-
-    if (DumpTokens) {
-        for (const Token &token : tokens) {
-            std::string location =
-                fmt::format("{}:{} -> {}:{}", token.begin.line, token.begin.col,
-                            token.end.line, token.end.col);
+    // Decompress gzip or zstd input in memory.
+    llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> decompressed =
+        compression::decompress(std::move(*inputBuffer));
+    if (!decompressed) {
+        llvm::WithColor::error(llvm::errs(), "microcc")
+            << fmt::format("{}: {}\n", InputFilename.getValue(),
+                           llvm::toString(decompressed.takeError()));
+        return EXIT_FAILURE;
+    }
 
-            fmt::print("{:20}{:20}{:20}\n", location, token.lexeme,
-                       token_type_to_string(token.type));
+    llvm::StringRef input = (*decompressed)->getBuffer();
+
+    // The input is either source code, or a token file written by the lexer
+    // (microcc -emit-tokens), in which case lexing is skipped.
+    std::optional<TokenFile> tokenFile;
+    if (TokenFile::isTokenFile(input)) {
+        llvm::Expected<TokenFile> file = TokenFile::read(input);
+        if (!file) {
+            llvm::WithColor::error(llvm::errs(), "microcc")
+                << fmt::format("{}: {}\n", InputFilename.getValue(),
+                               llvm::toString(file.takeError()));
+            return EXIT_FAILURE;
         }
+
+        tokenFile = std::move(*file);
     }
 
-    if (lexer.hadError())
+    std::string_view source =
+        tokenFile ? tokenFile->getSource() : std::string_view(input);
+
+    // Tokens refer to the source by 32-bit offsets.
+    if (source.size() > SourceManager::maxBufferSize) {
+        llvm::WithColor::error(llvm::errs(), "microcc") << fmt::format(
+            "{}: input is too large ({} bytes, at most {})\n",
+            InputFilename.getValue(), source.size(),
+            SourceManager::maxBufferSize);
         return EXIT_FAILURE;
+    }
+
+    // Phase 1: lexical analysis
+    // NOTE: The parser pulls tokens from the lexer on demand. Only when the
+    // tokens need to be dumped do we run a separate lexer over the input
+    // first, so that the dump and any lexer errors precede the parser's
+    // output, just like when lexing happens in full before parsing.
+    if (DumpTokens && tokenFile) {
+        SourceManager sourceManager{source};
+
+        TokenDumper dumper{sourceManager};
+        for (std::size_t i = 0; i < tokenFile->size(); ++i)
+            dumper.dump((*tokenFile)[i]);
+        dumper.flush();
+    } else if (DumpTokens) {
+        DiagnosticEngine diagnostics{ErrorLimit};
+        Lexer lexer{input, diagnostics};
+
+        const SourceManager &sourceManager = lexer.getSourceManager();
+
+        TokenDumper dumper{sourceManager};
+        while (std::optional<Token> token = lexer.next())
+            dumper.dump(*token);
+        dumper.flush();
+
+        diagnostics.flush(sourceManager);
+
+        if (diagnostics.hadError())
+            return EXIT_FAILURE;
+    }
+
+    // Errors of both phases are buffered, and printed at the end.
+    DiagnosticEngine diagnostics{ErrorLimit};
+
+    // The parser pulls the tokens from a token file, a lexer, or a lexer that
+    // runs ahead on its own thread.
+    std::optional<Lexer> lexer;
+    std::optional<ThreadedLexer> threadedLexer;
+
+    TokenSource *tokens;
+    if (tokenFile)
+        tokens = &*tokenFile;
+    else if (LexerThread)
+        tokens = &threadedLexer.emplace(input, diagnostics);
+    else
+        tokens = &lexer.emplace(input, diagnostics);
 
     // Phase 2: parsing
-    Parser parser{tokens};
+    // NOTE: The AST lives in the context, and is freed with it at the end.
+    ast::ASTContext context;
+    ast::Ptr<ast::Base> root;
+
+    if (Threads == 1) {
+        Parser parser{*tokens, diagnostics, context};
+        root = parser.parse();
+    } else {
+        ParallelParser parser{*tokens, diagnostics, context, Threads,
+                              ChunkSize};
+        root = parser.parse();
+    }
 
-    auto root = parser.parse();
+    diagnostics.flush(SourceManager{source});
 
-    if (parser.hadError())
+    if (diagnostics.hadError())
         return EXIT_FAILURE;
 
-    ast::PrettyPrinter printer(std::cout, AsciiMode);
+    if (SyntaxOnly)
+        return EXIT_SUCCESS;
+
+    ast::PrettyPrinter printer(std::cout, AsciiMode, DumpIds);
     printer.visit(*root, "", true);
 
     return EXIT_SUCCESS;
@@ -0,0 +1,216 @@
+#include "lexer/compression.hpp"
+
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/SmallVectorMemoryBuffer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <zlib.h>
+
+#ifdef MICROCC_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace compression {
+
+namespace {
+
+// Deflate cannot compress by more than a factor of about 1032, so larger size
+// hints are bogus. Zstd can, but then the output buffer simply grows.
+constexpr std::uint64_t maxRatio = 1032;
+
+// The decompressed text, filled from the front. The vector is larger than the
+// text, so that the decompressor can write into it directly.
+class Output {
+  public:
+    Output(std::uint64_t sizeHint, std::uint64_t inputSize) {
+        buffer.resize_for_overwrite(std::max<std::uint64_t>(
+            std::min(sizeHint, inputSize * maxRatio), minimumSize));
+    }
+
+    // Returns the free space after the text, growing the buffer if it is
+    // full.
+    char *space() {
+        if (size == buffer.size())
+            buffer.resize_for_overwrite(buffer.size() * 2);
+
+        return buffer.data() + size;
+    }
+
+    std::size_t spaceLeft() const { return buffer.size() - size; }
+
+    // Adds count bytes that were written to space() to the text.
+    void commit(std::size_t count) { size += count; }
+
+    std::unique_ptr<llvm::MemoryBuffer> take(llvm::StringRef name) {
+        buffer.truncate(size);
+        return std::make_unique<llvm::SmallVectorMemoryBuffer>(
+            std::move(buffer), name, false);
+    }
+
+  private:
+    static constexpr std::uint64_t minimumSize = 1 << 16;
+
+    llvm::SmallVector<char, 0> buffer;
+    std::size_t size = 0;
+};
+
+llvm::Error invalid(const char *format, const char *message) {
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "invalid %s data: %s", format, message);
+}
+
+llvm::Error truncated(const char *format) {
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "truncated %s data", format);
+}
+
+llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>>
+decompressGzip(const llvm::MemoryBuffer &input) {
+    llvm::StringRef data = input.getBuffer();
+
+    // The last four bytes hold the size of the (last) member modulo 2^32.
+    std::uint64_t sizeHint =
+        llvm::support::endian::read32le(data.end() - sizeof(std::uint32_t));
+    Output output{sizeHint, data.size()};
+
+    z_stream stream{};
+
+    // 16 selects the gzip format instead of the zlib format.
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK)
+        return invalid("gzip", "cannot initialize zlib");
+
+    auto cleanup = llvm::make_scope_exit([&stream] { inflateEnd(&stream); });
+
+    // zlib counts in 32 bits, so feed larger inputs in pieces.
+    const char *next = data.begin();
+
+    while (true) {
+        if (stream.avail_in == 0 && next != data.end()) {
+            std::size_t count =
+                std::min<std::size_t>(data.end() - next, UINT_MAX);
+            stream.next_in =
+                reinterpret_cast<Bytef *>(const_cast<char *>(next));
+            stream.avail_in = static_cast<uInt>(count);
+            next += count;
+        }
+
+        stream.next_out = reinterpret_cast<Bytef *>(output.space());
+        stream.avail_out = static_cast<uInt>(
+            std::min<std::size_t>(output.spaceLeft(), UINT_MAX));
+        uInt available = stream.avail_out;
+
+        int result = inflate(&stream, Z_NO_FLUSH);
+        output.commit(available - stream.avail_out);
+
+        bool inputLeft = stream.avail_in != 0 || next != data.end();
+
+        if (result == Z_STREAM_END) {
+            // Like gzip, ignore zeros after the last member, which pad the
+            // file to a block size, e.g. on tapes.
+            const char *rest = next - stream.avail_in;
+            if (std::all_of(rest, data.end(), [](char c) { return c == 0; }))
+                break;
+
+            // Another member follows, e.g. in concatenated .gz files.
+            inflateReset(&stream);
+        } else if (result == Z_BUF_ERROR) {
+            // No progress was possible: either the output is full, which
+            // space() fixes, or the input ended in the middle of a member.
+            if (stream.avail_out != 0 && !inputLeft)
+                return truncated("gzip");
+        } else if (result != Z_OK) {
+            return invalid("gzip", stream.msg ? stream.msg : "corrupt stream");
+        }
+    }
+
+    return output.take(input.getBufferIdentifier());
+}
+
+#ifdef MICROCC_HAVE_ZSTD
+llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>>
+decompressZstd(const llvm::MemoryBuffer &input) {
+    llvm::StringRef data = input.getBuffer();
+
+    // The size is in the frame header, unless the compressor streamed.
+    unsigned long long sizeHint =
+        ZSTD_getFrameContentSize(data.data(), data.size());
+    if (sizeHint == ZSTD_CONTENTSIZE_UNKNOWN ||
+        sizeHint == ZSTD_CONTENTSIZE_ERROR)
+        sizeHint = 0;
+
+    Output output{sizeHint, data.size()};
+
+    std::unique_ptr<ZSTD_DStream, decltype(&ZSTD_freeDStream)> stream{
+        ZSTD_createDStream(), ZSTD_freeDStream};
+    if (!stream)
+        return invalid("zstd", "cannot initialize zstd");
+
+    ZSTD_inBuffer in{data.data(), data.size(), 0};
+
+    while (true) {
+        ZSTD_outBuffer out{output.space(), output.spaceLeft(), 0};
+
+        // Returns 0 at the end of a frame; multiple frames follow each other.
+        std::size_t result = ZSTD_decompressStream(stream.get(), &out, &in);
+        output.commit(out.pos);
+
+        if (ZSTD_isError(result))
+            return invalid("zstd", ZSTD_getErrorName(result));
+
+        if (in.pos == in.size) {
+            if (result == 0)
+                break;
+
+            // The frame is not complete, and the output buffer had room left,
+            // so it needs more input.
+            if (out.pos < out.size)
+                return truncated("zstd");
+        }
+    }
+
+    return output.take(input.getBufferIdentifier());
+}
+#endif
+
+} // namespace
+
+Format detect(llvm::StringRef data) {
+    if (data.startswith("\x1f\x8b"))
+        return Format::Gzip;
+
+    if (data.startswith("\x28\xb5\x2f\xfd"))
+        return Format::Zstd;
+
+    return Format::None;
+}
+
+llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>>
+decompress(std::unique_ptr<llvm::MemoryBuffer> input) {
+    switch (detect(input->getBuffer())) {
+    case Format::None:
+        return input;
+    case Format::Gzip:
+        // The smallest gzip member has a 10-byte header and an 8-byte trailer.
+        if (input->getBufferSize() < 18)
+            return truncated("gzip");
+        return decompressGzip(*input);
+    case Format::Zstd:
+#ifdef MICROCC_HAVE_ZSTD
+        return decompressZstd(*input);
+#else
+        return llvm::createStringError(
+            llvm::inconvertibleErrorCode(),
+            "zstd-compressed input is not supported by this build");
+#endif
+    }
+
+    return input;
+}
+
+} // namespace compression
@@ -0,0 +1,34 @@
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+#include <memory>
+
+// Support for compressed source files.
+//
+// Compressed inputs are recognised by their magic number, not by their
+// extension, so that they can also be read from stdin. They are decompressed
+// in one streaming pass straight into the buffer that the lexer reads, without
+// temporary files.
+namespace compression {
+
+enum class Format {
+    None,
+    Gzip,
+    Zstd,
+};
+
+// Returns the format of data, based on its first bytes.
+Format detect(llvm::StringRef data);
+
+// Returns the decompressed contents of input if it is compressed, and input
+// itself otherwise. Zstd is only supported if the build found libzstd.
+llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>>
+decompress(std::unique_ptr<llvm::MemoryBuffer> input);
+
+} // namespace compression
+
+#endif /* end of include guard: COMPRESSION_HPP */
@@ -0,0 +1,75 @@
+#include "lexer/diagnosticengine.hpp"
+
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cstring>
+#include <fmt/core.h>
+#include <utility>
+
+DiagnosticEngine::DiagnosticEngine(unsigned errorLimit)
+    : errorLimit(errorLimit) {}
+
+void DiagnosticEngine::error(const char *phase, const char *position,
+                             std::string_view text, std::string message) {
+    errorFlag = true;
+
+    if (limitReached)
+        return;
+
+    if (!diagnostics.empty()) {
+        Diagnostic &last = diagnostics.back();
+
+        if (text.data() == last.textEnd &&
+            std::strcmp(last.phase, phase) == 0 && last.message == message) {
+            ++last.repetitions;
+            last.lastPosition = position;
+            last.textEnd = text.data() + text.size();
+            return;
+        }
+    }
+
+    if (errorLimit != 0 && errorCount == errorLimit) {
+        limitReached = true;
+        return;
+    }
+
+    ++errorCount;
+    diagnostics.push_back({phase, position, std::move(message), 0, nullptr,
+                           text.data() + text.size()});
+}
+
+bool DiagnosticEngine::hadError() const { return errorFlag; }
+
+bool DiagnosticEngine::reachedErrorLimit() const { return limitReached; }
+
+void DiagnosticEngine::flush(const SourceManager &sourceManager) {
+    llvm::raw_ostream &os = llvm::errs();
+
+    // Write everything at once, instead of once per diagnostic.
+    os.SetBuffered();
+
+    for (const Diagnostic &diagnostic : diagnostics) {
+        Location location = sourceManager.getLocation(diagnostic.position);
+        llvm::WithColor::error(os, diagnostic.phase)
+            << fmt::format("{}:{}: {}\n", location.line, location.col,
+                           diagnostic.message);
+
+        if (diagnostic.repetitions == 0)
+            continue;
+
+        location = sourceManager.getLocation(diagnostic.lastPosition);
+        llvm::WithColor::note(os, diagnostic.phase) << fmt::format(
+            "{}:{}: previous error repeated {} more time{}\n", location.line,
+            location.col, diagnostic.repetitions,
+            diagnostic.repetitions == 1 ? "" : "s");
+    }
+
+    if (limitReached)
+        llvm::WithColor::error(os, "microcc") << fmt::format(
+            "too many errors emitted, stopping now [-ferror-limit={}]\n",
+            errorLimit);
+
+    os.SetUnbuffered();
+    diagnostics.clear();
+}
@@ -0,0 +1,66 @@
+#ifndef DIAGNOSTICENGINE_HPP
+#define DIAGNOSTICENGINE_HPP
+
+#include "lexer/sourcemanager.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Collects the errors of all phases of the compiler, and prints them in one go
+// at the end.
+//
+// Runs of identical errors (e.g. an invalid character for every byte of a
+// binary file) are reported once, followed by a note with the number of
+// repetitions. An error only belongs to the run of the previous one if its
+// text starts where the text of the previous one ends, as in "@@@@@".
+//
+// With an error limit, errors after the first errorLimit are dropped, and the
+// phases are expected to stop as soon as reachedErrorLimit() returns true.
+class DiagnosticEngine {
+  public:
+    // An error limit of 0 means that there is no limit.
+    DiagnosticEngine(unsigned errorLimit = 0);
+
+    // Reports an error of the given phase (e.g. "lexer") at a position in the
+    // source buffer. text is the part of the source that the error is about
+    // (e.g. an invalid character), which is used to detect runs.
+    void error(const char *phase, const char *position, std::string_view text,
+               std::string message);
+
+    bool hadError() const;
+
+    // Returns true if the error limit was reached, so that compilation should
+    // stop.
+    bool reachedErrorLimit() const;
+
+    // Prints all buffered diagnostics to llvm::errs(), using sourceManager to
+    // compute their locations, and clears the buffer.
+    void flush(const SourceManager &sourceManager);
+
+  private:
+    struct Diagnostic {
+        const char *phase;
+        const char *position;
+        std::string message;
+
+        // Number of times the same error followed directly, and the position
+        // of the last of them.
+        std::size_t repetitions = 0;
+        const char *lastPosition = nullptr;
+
+        // End of the text of the last error of the run.
+        const char *textEnd;
+    };
+
+    std::vector<Diagnostic> diagnostics;
+
+    unsigned errorLimit;
+    unsigned errorCount = 0;
+
+    bool errorFlag = false;
+    bool limitReached = false;
+};
+
+#endif /* end of include guard: DIAGNOSTICENGINE_HPP */
@@ -0,0 +1,23 @@
+#include "lexer/identifiertable.hpp"
+
+#include <cassert>
+
+Identifier IdentifierTable::get(std::string_view spelling) {
+    auto [it, inserted] = ids.try_emplace(
+        llvm::StringRef(spelling.data(), spelling.size()),
+        static_cast<std::uint32_t>(spellings.size()));
+
+    if (inserted)
+        spellings.push_back(it->getKey());
+
+    return Identifier{it->getValue()};
+}
+
+std::string_view IdentifierTable::getSpelling(Identifier identifier) const {
+    assert(identifier.id < spellings.size() && "Unknown identifier!");
+
+    llvm::StringRef spelling = spellings[identifier.id];
+    return std::string_view(spelling.data(), spelling.size());
+}
+
+std::size_t IdentifierTable::size() const { return spellings.size(); }
@@ -0,0 +1,37 @@
+#ifndef IDENTIFIERTABLE_HPP
+#define IDENTIFIERTABLE_HPP
+
+#include "lexer/token.hpp"
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringRef.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Interns the spellings of identifiers.
+//
+// Every distinct spelling is stored once and gets a small integer handle, in
+// the order in which the spellings are first seen. The spellings are copied
+// into the table, so handles and spellings stay valid independently of the
+// source buffer.
+class IdentifierTable {
+  public:
+    // Returns the handle for the given spelling, adding it to the table if it
+    // is new.
+    Identifier get(std::string_view spelling);
+
+    // Returns the spelling of an identifier in this table.
+    std::string_view getSpelling(Identifier identifier) const;
+
+    // Returns the number of distinct identifiers.
+    std::size_t size() const;
+
+  private:
+    llvm::StringMap<std::uint32_t> ids;
+    std::vector<llvm::StringRef> spellings;
+};
+
+#endif /* end of include guard: IDENTIFIERTABLE_HPP */
@@ -0,0 +1,257 @@
+#include "lexer.hpp"
+#include "lexer/dfa.hpp"
+#include "lexer/keywords.hpp"
+#include "lexer/scanner.hpp"
+#include "lexer/utf8.hpp"
+
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/WithColor.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <cassert>
+#include <charconv>
+#include <fmt/core.h>
+#include <system_error>
+#include <utility>
+
+#define DEBUG_TYPE "lexer"
+
+Lexer::Lexer(std::string_view input) : Lexer(input, input) {}
+
+Lexer::Lexer(std::string_view input, DiagnosticEngine &diagnostics)
+    : Lexer(input) {
+    this->diagnostics = &diagnostics;
+}
+
+Lexer::Lexer(std::string_view input, std::string_view range)
+    : input(input), sourceManager(input) {
+    assert(range.data() >= input.data() &&
+           range.data() + range.size() <= input.data() + input.size() &&
+           "Range is not a part of the input!");
+
+    begin = end = range.data();
+    rangeEnd = range.data() + range.size();
+}
+
+std::optional<Token> Lexer::next() {
+    while (begin < rangeEnd) {
+        if (diagnostics && diagnostics->reachedErrorLimit())
+            break;
+
+        std::optional<Token> token = lexToken();
+
+        begin = end;
+
+        if (token)
+            return token;
+    }
+
+    return std::nullopt;
+}
+
+std::vector<Token> Lexer::getTokens() {
+    std::vector<Token> tokens;
+
+    while (std::optional<Token> token = next())
+        tokens.push_back(*token);
+
+    return tokens;
+}
+
+TokenBuffer Lexer::getTokenBuffer() {
+    TokenBuffer tokens{input};
+
+    while (std::optional<Token> token = next())
+        tokens.push_back(*token);
+
+    return tokens;
+}
+
+bool Lexer::hadError() const { return errorFlag; }
+
+void Lexer::deferErrors() { deferringErrors = true; }
+
+const std::vector<Lexer::Error> &Lexer::getErrors() const { return errors; }
+
+void Lexer::printError(const SourceManager &sourceManager,
+                       const Error &error) {
+    Location location = sourceManager.getLocation(error.position);
+    llvm::WithColor::error(llvm::errs(), "lexer") << fmt::format(
+        "{}:{}: {}\n", location.line, location.col, error.message);
+}
+
+const char *Lexer::getPosition() const { return begin; }
+
+const SourceManager &Lexer::getSourceManager() const { return sourceManager; }
+
+const IdentifierTable &Lexer::getIdentifierTable() const { return identifiers; }
+
+bool Lexer::isAtEnd() const { return end == inputEnd(); }
+
+const char *Lexer::inputEnd() const { return input.data() + input.size(); }
+
+std::optional<Token> Lexer::lexToken() {
+    // ASSIGNMENT: Implement the lexical analyser here.
+    dfa::State state = dfa::State::Start;
+
+    while (true) {
+        dfa::CharClass cls =
+            isAtEnd() ? dfa::CharClass::EndOfInput : dfa::classify(peek());
+        dfa::Transition transition = dfa::transition(state, cls);
+
+        if (transition.next == dfa::State::Stop)
+            break;
+
+        if (transition.error)
+            error(dfa::info(state).error);
+
+        ++end;
+        state = transition.next;
+        skipRun(dfa::info(state).run);
+    }
+
+    const dfa::StateInfo &info = dfa::info(state);
+
+    if (info.token) {
+        switch (*info.token) {
+        case TokenType::IDENTIFIER:
+            return makeIdentifier();
+        case TokenType::INT_LITERAL:
+            return makeIntLiteral();
+        case TokenType::FLOAT_LITERAL:
+            return makeFloatLiteral();
+        default:
+            return makeToken(*info.token);
+        }
+    } else if (state == dfa::State::Invalid) {
+        invalidCharacter(info.error);
+    } else if (info.error) {
+        error(info.error);
+    }
+
+    return std::nullopt;
+}
+
+void Lexer::skipRun(dfa::Run run) {
+    switch (run) {
+    case dfa::Run::None:
+        break;
+    case dfa::Run::Whitespace:
+        advanceTo(scanner::skip<scanner::Whitespace>(end, inputEnd()));
+        break;
+    case dfa::Run::IdentifierChars:
+        advanceTo(scanner::skip<scanner::IdentifierChars>(end, inputEnd()));
+        break;
+    case dfa::Run::Digits:
+        advanceTo(scanner::skip<scanner::Digits>(end, inputEnd()));
+        break;
+    case dfa::Run::LineBody:
+        skipText<scanner::LineBody>();
+        break;
+    case dfa::Run::StringBody:
+        skipText<scanner::StringBody>();
+        break;
+    }
+}
+
+template <typename Class> void Lexer::skipText() {
+    const char *p = scanner::skip<scanner::Ascii<Class>>(end, inputEnd());
+
+    // Most text is ASCII. Otherwise, find the end of the run, and check that
+    // the rest of it is valid UTF-8.
+    if (p != inputEnd() && !scanner::isAscii(*p)) {
+        const char *runEnd = scanner::skip<Class>(p, inputEnd());
+
+        while ((p = utf8::findInvalid(p, runEnd)) != runEnd) {
+            std::size_t length = utf8::invalidLength(p, runEnd);
+            error(p, {p, length}, "Invalid UTF-8 sequence");
+            p += length;
+        }
+    }
+
+    advanceTo(p);
+}
+
+void Lexer::invalidCharacter(const char *message) {
+    if (scanner::isAscii(*begin)) {
+        error(fmt::format("{} '{}'", message, *begin));
+        return;
+    }
+
+    // Report a multibyte character once, instead of once for every byte.
+    if (std::size_t length = utf8::sequenceLength(begin, inputEnd())) {
+        advanceTo(begin + length);
+        error(fmt::format("{} '{}'", message, getLexeme()));
+    } else {
+        advanceTo(begin + utf8::invalidLength(begin, inputEnd()));
+        error("Invalid UTF-8 sequence");
+    }
+}
+
+Token Lexer::makeToken(TokenType type) const {
+    return Token(type, getLexeme());
+}
+
+Token Lexer::makeIdentifier() {
+    std::string_view lexeme = getLexeme();
+    TokenType type = keywords::classify(lexeme);
+
+    if (type != TokenType::IDENTIFIER)
+        return makeToken(type);
+
+    return Token(type, lexeme, identifiers.get(lexeme));
+}
+
+Token Lexer::makeIntLiteral() {
+    Token token = makeToken(TokenType::INT_LITERAL);
+    token.intValue = 0;
+
+    if (std::from_chars(begin, end, token.intValue).ec ==
+        std::errc::result_out_of_range)
+        error(begin, getLexeme(), "Integer literal is out of range");
+
+    return token;
+}
+
+Token Lexer::makeFloatLiteral() {
+    Token token = makeToken(TokenType::FLOAT_LITERAL);
+    token.floatValue = 0;
+
+    if (std::from_chars(begin, end, token.floatValue,
+                        std::chars_format::fixed)
+            .ec == std::errc::result_out_of_range)
+        error(begin, getLexeme(), "Float literal is out of range");
+
+    return token;
+}
+
+void Lexer::advanceTo(const char *position) { end = position; }
+
+char Lexer::peek() {
+    if (!isAtEnd())
+        return *end;
+    else
+        return '\0';
+}
+
+void Lexer::error(const std::string &message) {
+    error(end, getLexeme(), message);
+}
+
+void Lexer::error(const char *position, std::string_view text,
+                  const std::string &message) {
+    errorFlag = true;
+
+    Error reported{begin, position, text, message};
+
+    if (deferringErrors)
+        errors.push_back(std::move(reported));
+    else if (diagnostics)
+        diagnostics->error("lexer", position, text, message);
+    else
+        printError(sourceManager, reported);
+}
+
+std::string_view Lexer::getLexeme() const {
+    return std::string_view{begin, static_cast<std::size_t>(end - begin)};
+}
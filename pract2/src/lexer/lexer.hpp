@@ -1,54 +1,160 @@
 #ifndef LEXER_HPP
 #define LEXER_HPP
 
+#include "lexer/dfa.hpp"
+#include "lexer/diagnosticengine.hpp"
+#include "lexer/identifiertable.hpp"
+#include "lexer/sourcemanager.hpp"
 #include "lexer/token.hpp"
+#include "lexer/tokenbuffer.hpp"
+#include "lexer/tokensource.hpp"
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
-class Lexer {
+class Lexer final : public TokenSource {
   public:
-    Lexer(const std::string &input);
+    // NOTE: The lexer does not copy the input, so the buffer must outlive both
+    // the lexer and the tokens it produces.
+    Lexer(std::string_view input);
+
+    // Creates a lexer that reports its errors to diagnostics, instead of
+    // printing them as they occur. It stops once the error limit is reached.
+    Lexer(std::string_view input, DiagnosticEngine &diagnostics);
+
+    // Creates a lexer that only produces the tokens that start in range, which
+    // must be a view into input. The last token may extend past the end of the
+    // range. The lexer assumes that a token starts at the beginning of range.
+    Lexer(std::string_view input, std::string_view range);
+
+    // An error that was reported while lexing.
+    struct Error {
+        // Beginning of the run of characters that contains the error.
+        const char *runBegin;
+
+        // Position at which the error was reported.
+        const char *position;
+
+        // The text that the error is about, e.g. an invalid character.
+        std::string_view text;
+
+        std::string message;
+    };
+
+    // Lexes and returns the next token, or std::nullopt once the entire input
+    // is processed. Tokens are produced on demand, so the token stream never
+    // has to be in memory as a whole.
+    std::optional<Token> next() override;
+
+    // Lexes the entire input and returns all tokens.
     std::vector<Token> getTokens();
-    bool hadError() const;
+
+    // Lexes the entire input and returns all tokens in compact form.
+    TokenBuffer getTokenBuffer();
+
+    bool hadError() const override;
+
+    // Keeps errors in getErrors() instead of printing them as they occur.
+    void deferErrors();
+
+    // Returns the errors that were deferred so far.
+    const std::vector<Error> &getErrors() const;
+
+    // Prints an error, using sourceManager to compute its location.
+    static void printError(const SourceManager &sourceManager,
+                           const Error &error);
+
+    // Returns the position where the next token will start, i.e. the end of
+    // the input or the range when lexing is done.
+    const char *getPosition() const;
+
+    // Returns the source manager that computes the locations of the tokens.
+    const SourceManager &getSourceManager() const;
+
+    // Returns the table with the interned spellings of all identifiers seen so
+    // far.
+    const IdentifierTable &getIdentifierTable() const;
 
   private:
-    // String containing the input.
-    std::string input;
+    // View of the input. The lexemes of all tokens point into this buffer.
+    std::string_view input;
+
+    // Computes locations in the input for diagnostics.
+    SourceManager sourceManager;
+
+    // Interned spellings of identifiers, filled during lexing.
+    IdentifierTable identifiers;
 
-    // Iterators to the beginning and one-past-the-end of the current token.
-    std::string::const_iterator begin, end;
+    // Receives the errors, if set.
+    DiagnosticEngine *diagnostics = nullptr;
 
-    // Location of begin and end in the source file.
-    Location begin_location, end_location;
+    // Pointers to the beginning and one-past-the-end of the current token.
+    const char *begin, *end;
 
-    // List of tokens
-    std::vector<Token> tokens;
+    // One-past-the-end of the range in which tokens may start.
+    const char *rangeEnd;
 
     // Flag that is set when an error occurs.
     bool errorFlag = false;
 
+    // Whether errors are kept in errors instead of printed.
+    bool deferringErrors = false;
+
+    std::vector<Error> errors;
+
     // Returns true if the entire input is processed.
     bool isAtEnd() const;
 
-    // Lexes the next token in the input.
-    void lexToken();
+    // Lexes the next token in the input, by running the automaton in
+    // lexer/dfa.hpp until it stops. Returns std::nullopt if the characters
+    // that were consumed do not form a token (e.g. whitespace or errors).
+    std::optional<Token> lexToken();
+
+    // Adds a run of characters of the given kind to the current token.
+    void skipRun(dfa::Run run);
 
-    // Helper method to add a token to the list of tokens.
-    void emitToken(TokenType type);
+    // Adds the body of a comment or string literal, as accepted by the
+    // scanner class, to the current token. Invalid UTF-8 is reported.
+    template <typename Class> void skipText();
 
-    // Adds the next character in the input to the current token.
-    void advance();
+    // Reports the invalid character at the beginning of the current token
+    // with the given message, and adds all of its bytes to the token.
+    void invalidCharacter(const char *message);
+
+    // Helper method to create a token for the current lexeme.
+    Token makeToken(TokenType type) const;
+
+    // Creates a keyword or identifier token for the current lexeme. The
+    // spelling of identifiers is interned.
+    Token makeIdentifier();
+
+    // Create a literal token for the current lexeme, with its decoded value.
+    // Values that do not fit in the type are reported as an error.
+    Token makeIntLiteral();
+    Token makeFloatLiteral();
+
+    // Adds all characters up to (but not including) position to the current
+    // token.
+    void advanceTo(const char *position);
+
+    // Returns a pointer one-past-the-end of the input.
+    const char *inputEnd() const;
 
     // Peeks the next character in the input stream, without adding it to the
     // current token.
     char peek();
 
-    // Reports an error at the current position.
+    // Reports an error about the current lexeme at the current position.
     void error(const std::string &message);
 
-    // Get the current lexeme.
-    std::string getLexeme() const;
+    // Reports an error about text at the given position in the current token.
+    void error(const char *position, std::string_view text,
+               const std::string &message);
+
+    // Get the current lexeme, as a view into the input.
+    std::string_view getLexeme() const;
 };
 
 #endif /* end of include guard: LEXER_HPP */
@@ -0,0 +1,196 @@
+#ifndef SCANNER_HPP
+#define SCANNER_HPP
+
+// Helpers to scan runs of characters in the input 16 or 32 bytes at a time.
+// The vector width is chosen at compile time: AVX2 if the compiler targets it
+// (e.g. with -mavx2 or -march=native), SSE2 on any other x86-64 target, and a
+// plain scalar loop everywhere else. The scalar loop also handles the tail of
+// the input that does not fill a whole block.
+//
+// All classifications are ASCII-only and do not depend on the current locale.
+// Bytes of multibyte UTF-8 sequences are only accepted by the classes that
+// accept any byte except a few ASCII terminators (LineBody and StringBody).
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace scanner {
+
+#if defined(__AVX2__)
+struct Block {
+    using Vec = __m256i;
+    static constexpr int size = 32;
+
+    static Vec load(const char *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    }
+    static Vec splat(char c) { return _mm256_set1_epi8(c); }
+    static Vec eq(Vec a, Vec b) { return _mm256_cmpeq_epi8(a, b); }
+    static Vec either(Vec a, Vec b) { return _mm256_or_si256(a, b); }
+    static Vec both(Vec a, Vec b) { return _mm256_and_si256(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm256_sub_epi8(a, b); }
+    static Vec min(Vec a, Vec b) { return _mm256_min_epu8(a, b); }
+    static unsigned mask(Vec v) {
+        return static_cast<unsigned>(_mm256_movemask_epi8(v));
+    }
+    static constexpr unsigned full = 0xFFFFFFFFu;
+};
+#define SCANNER_HAS_BLOCK
+#elif defined(__SSE2__)
+struct Block {
+    using Vec = __m128i;
+    static constexpr int size = 16;
+
+    static Vec load(const char *p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    }
+    static Vec splat(char c) { return _mm_set1_epi8(c); }
+    static Vec eq(Vec a, Vec b) { return _mm_cmpeq_epi8(a, b); }
+    static Vec either(Vec a, Vec b) { return _mm_or_si128(a, b); }
+    static Vec both(Vec a, Vec b) { return _mm_and_si128(a, b); }
+    static Vec sub(Vec a, Vec b) { return _mm_sub_epi8(a, b); }
+    static Vec min(Vec a, Vec b) { return _mm_min_epu8(a, b); }
+    static unsigned mask(Vec v) {
+        return static_cast<unsigned>(_mm_movemask_epi8(v));
+    }
+    static constexpr unsigned full = 0xFFFFu;
+};
+#define SCANNER_HAS_BLOCK
+#endif
+
+// Scalar classification of a single character.
+inline bool inRange(char c, char lo, char hi) {
+    return static_cast<unsigned char>(c - lo) <=
+           static_cast<unsigned char>(hi - lo);
+}
+
+inline bool isDigit(char c) { return inRange(c, '0', '9'); }
+
+inline bool isAlpha(char c) { return inRange(c | 0x20, 'a', 'z'); }
+
+inline bool isIdentifierStart(char c) { return isAlpha(c) || c == '_'; }
+
+inline bool isIdentifierChar(char c) { return isIdentifierStart(c) || isDigit(c); }
+
+inline bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+inline bool isAscii(char c) { return !(c & 0x80); }
+
+#ifdef SCANNER_HAS_BLOCK
+// Vector classification of a whole block. Each byte of the result is 0xFF if
+// the corresponding input byte is in the class, and 0x00 otherwise.
+inline Block::Vec inRange(Block::Vec v, char lo, char hi) {
+    Block::Vec offset = Block::sub(v, Block::splat(lo));
+    return Block::eq(Block::min(offset, Block::splat(hi - lo)), offset);
+}
+
+inline Block::Vec isDigit(Block::Vec v) { return inRange(v, '0', '9'); }
+
+inline Block::Vec isIdentifierChar(Block::Vec v) {
+    return Block::either(
+        Block::either(inRange(Block::either(v, Block::splat(0x20)), 'a', 'z'),
+                      isDigit(v)),
+        Block::eq(v, Block::splat('_')));
+}
+
+inline Block::Vec isAscii(Block::Vec v) { return inRange(v, 0x00, 0x7F); }
+
+inline Block::Vec isWhitespace(Block::Vec v) {
+    return Block::either(Block::either(Block::eq(v, Block::splat(' ')),
+                                       Block::eq(v, Block::splat('\t'))),
+                         Block::either(Block::eq(v, Block::splat('\n')),
+                                       Block::eq(v, Block::splat('\r'))));
+}
+#endif
+
+// Character classes that the lexer skips over in one go. Each class accepts
+// the characters that belong to the run; scanning stops at the first character
+// that is not accepted.
+struct Whitespace {
+    static bool accepts(char c) { return isWhitespace(c); }
+#ifdef SCANNER_HAS_BLOCK
+    static Block::Vec accepts(Block::Vec v) { return isWhitespace(v); }
+#endif
+};
+
+struct IdentifierChars {
+    static bool accepts(char c) { return isIdentifierChar(c); }
+#ifdef SCANNER_HAS_BLOCK
+    static Block::Vec accepts(Block::Vec v) { return isIdentifierChar(v); }
+#endif
+};
+
+struct Digits {
+    static bool accepts(char c) { return isDigit(c); }
+#ifdef SCANNER_HAS_BLOCK
+    static Block::Vec accepts(Block::Vec v) { return isDigit(v); }
+#endif
+};
+
+// Everything up to the end of the line (i.e. the body of a // comment).
+struct LineBody {
+    static bool accepts(char c) { return c != '\n'; }
+#ifdef SCANNER_HAS_BLOCK
+    static Block::Vec accepts(Block::Vec v) {
+        return Block::eq(Block::eq(v, Block::splat('\n')), Block::splat(0));
+    }
+#endif
+};
+
+// Everything up to the closing quote or the end of the line (i.e. the body of
+// a string literal).
+struct StringBody {
+    static bool accepts(char c) { return c != '"' && c != '\n'; }
+#ifdef SCANNER_HAS_BLOCK
+    static Block::Vec accepts(Block::Vec v) {
+        Block::Vec stop = Block::either(Block::eq(v, Block::splat('"')),
+                                        Block::eq(v, Block::splat('\n')));
+        return Block::eq(stop, Block::splat(0));
+    }
+#endif
+};
+
+// Any ASCII character.
+struct AsciiChars {
+    static bool accepts(char c) { return isAscii(c); }
+#ifdef SCANNER_HAS_BLOCK
+    static Block::Vec accepts(Block::Vec v) { return isAscii(v); }
+#endif
+};
+
+// The ASCII characters that Class accepts, e.g. to find the first non-ASCII
+// character in the body of a comment.
+template <typename Class> struct Ascii {
+    static bool accepts(char c) { return isAscii(c) && Class::accepts(c); }
+#ifdef SCANNER_HAS_BLOCK
+    static Block::Vec accepts(Block::Vec v) {
+        return Block::both(isAscii(v), Class::accepts(v));
+    }
+#endif
+};
+
+// Returns a pointer to the first character in [p, end) that is not accepted by
+// Class, or end if there is no such character.
+template <typename Class> const char *skip(const char *p, const char *end) {
+#ifdef SCANNER_HAS_BLOCK
+    while (end - p >= Block::size) {
+        unsigned stop = ~Block::mask(Class::accepts(Block::load(p))) &
+                        Block::full;
+        if (stop)
+            return p + __builtin_ctz(stop);
+        p += Block::size;
+    }
+#endif
+    while (p != end && Class::accepts(*p))
+        ++p;
+    return p;
+}
+
+} // namespace scanner
+
+#undef SCANNER_HAS_BLOCK
+
+#endif /* end of include guard: SCANNER_HPP */
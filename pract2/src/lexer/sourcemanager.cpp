@@ -0,0 +1,111 @@
+#include "lexer/sourcemanager.hpp"
+#include "lexer/scanner.hpp"
+#include "lexer/utf8.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+SourceManager::SourceManager(std::string_view buffer) : buffer(buffer) {
+    assert(buffer.size() <= maxBufferSize &&
+           "Source buffer is too large for 32-bit offsets!");
+}
+
+Location SourceManager::getLocation(const char *position) const {
+    computeLineOffsets();
+
+    std::uint32_t offset = getOffset(position);
+    std::size_t line = findLine(offset);
+
+    return Location(line + 1, getColumn(line, offset));
+}
+
+Location SourceManager::getBeginLocation(const Token &token) const {
+    return getLocation(token.lexeme.data());
+}
+
+Location SourceManager::getEndLocation(const Token &token) const {
+    return getLocation(token.lexeme.data() + token.lexeme.size());
+}
+
+std::uint32_t SourceManager::getOffset(const char *position) const {
+    assert(position >= buffer.data() &&
+           position <= buffer.data() + buffer.size() &&
+           "Position is not in the source buffer!");
+
+    return static_cast<std::uint32_t>(position - buffer.data());
+}
+
+std::string_view SourceManager::getBuffer() const { return buffer; }
+
+void SourceManager::computeLineOffsets() const {
+    if (!lineOffsets.empty())
+        return;
+
+    const char *end = buffer.data() + buffer.size();
+    const char *p = buffer.data();
+
+    lineOffsets.push_back(0);
+
+    while (true) {
+        p = scanner::skip<scanner::Ascii<scanner::LineBody>>(p, end);
+
+        bool ascii = p == end || *p == '\n';
+        if (!ascii)
+            p = scanner::skip<scanner::LineBody>(p, end);
+
+        asciiLines.push_back(ascii);
+
+        if (p == end)
+            break;
+
+        ++p;
+        lineOffsets.push_back(getOffset(p));
+    }
+}
+
+std::size_t SourceManager::findLine(std::uint32_t offset) const {
+    auto containsOffset = [this, offset](std::size_t line) {
+        return lineOffsets[line] <= offset &&
+               (line + 1 == lineOffsets.size() ||
+                offset < lineOffsets[line + 1]);
+    };
+
+    // Most queries are for the same line as the previous one, or the next.
+    if (containsOffset(lastLine))
+        return lastLine;
+
+    if (lastLine + 1 < lineOffsets.size() && containsOffset(lastLine + 1))
+        return ++lastLine;
+
+    auto it = std::upper_bound(lineOffsets.begin(), lineOffsets.end(), offset);
+    lastLine = (it - lineOffsets.begin()) - 1;
+
+    return lastLine;
+}
+
+std::uint32_t SourceManager::getColumn(std::size_t line,
+                                       std::uint32_t offset) const {
+    std::uint32_t lineOffset = lineOffsets[line];
+
+    if (asciiLines[line])
+        return offset - lineOffset + 1;
+
+    // Count the characters since the start of the line, or since the
+    // previous query if that was earlier on the same line.
+    std::uint32_t from = lineOffset;
+    std::uint32_t column = 1;
+
+    if (columnLine == line && columnOffset <= offset) {
+        from = columnOffset;
+        column = columnNumber;
+    }
+
+    column += static_cast<std::uint32_t>(utf8::countCharacters(
+        buffer.data() + from, buffer.data() + offset));
+
+    columnLine = line;
+    columnOffset = offset;
+    columnNumber = column;
+
+    return column;
+}
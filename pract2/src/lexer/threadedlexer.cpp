@@ -0,0 +1,157 @@
+#include "lexer/threadedlexer.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+ThreadedLexer::ThreadedLexer(std::string_view input,
+                             DiagnosticEngine &diagnostics,
+                             std::size_t batchSize, std::size_t queueSize)
+    : batchSize(std::max<std::size_t>(batchSize, 1)), lexer(input),
+      diagnostics(diagnostics), queue(std::max<std::size_t>(queueSize, 1)) {
+    lexer.deferErrors();
+    thread = std::thread(&ThreadedLexer::produce, this);
+}
+
+ThreadedLexer::~ThreadedLexer() { stop(); }
+
+std::optional<Token> ThreadedLexer::next() {
+    while (!finished) {
+        // Report the errors that precede the next token. The Lexer checks the
+        // error limit before every run of characters, so do the same.
+        while (nextError < current.errors.size() &&
+               current.errors[nextError].first == nextToken) {
+            const Lexer::Error &error = current.errors[nextError].second;
+
+            if (error.runBegin != lastRunBegin &&
+                diagnostics.reachedErrorLimit()) {
+                stop();
+                return std::nullopt;
+            }
+
+            lastRunBegin = error.runBegin;
+            errorFlag = true;
+            diagnostics.error("lexer", error.position, error.text,
+                              error.message);
+            ++nextError;
+        }
+
+        if (nextToken < current.tokens.size()) {
+            const Token &token = current.tokens[nextToken];
+
+            if (token.lexeme.data() != lastRunBegin &&
+                diagnostics.reachedErrorLimit()) {
+                stop();
+                return std::nullopt;
+            }
+
+            ++nextToken;
+            return token;
+        }
+
+        if (current.last) {
+            stop();
+            return std::nullopt;
+        }
+
+        receive();
+    }
+
+    return std::nullopt;
+}
+
+bool ThreadedLexer::hadError() const { return errorFlag; }
+
+const IdentifierTable &ThreadedLexer::getIdentifierTable() const {
+    return lexer.getIdentifierTable();
+}
+
+void ThreadedLexer::produce() {
+    Batch batch;
+    batch.tokens.reserve(batchSize);
+
+    std::size_t sentErrors = 0;
+
+    while (true) {
+        std::optional<Token> token = lexer.next();
+
+        const std::vector<Lexer::Error> &errors = lexer.getErrors();
+        for (; sentErrors < errors.size(); ++sentErrors)
+            batch.errors.emplace_back(batch.tokens.size(), errors[sentErrors]);
+
+        if (token)
+            batch.tokens.push_back(*token);
+        else
+            batch.last = true;
+
+        if (batch.last || batch.tokens.size() == batchSize) {
+            if (!send(batch) || !token)
+                return;
+        }
+    }
+}
+
+template <typename Predicate>
+void ThreadedLexer::wait(std::unique_lock<std::mutex> &lock, Predicate ready) {
+    // NOTE: This waits with a timeout, because the plain
+    // std::condition_variable::wait() requires a newer libstdc++ at run time
+    // than the one that some toolchains (e.g. conda environments) ship with.
+    // The timeout only bounds each sleep; the loop keeps waiting until ready.
+    while (!changed.wait_for(lock, std::chrono::seconds(1), ready))
+        ;
+}
+
+bool ThreadedLexer::send(Batch &batch) {
+    std::unique_lock<std::mutex> lock{mutex};
+
+    wait(lock, [this] { return sent - received != queue.size() || stopping; });
+
+    bool stopped = stopping;
+
+    if (!stopped) {
+        // Swap, so that batch reuses the memory of a batch that was consumed.
+        std::swap(queue[sent % queue.size()], batch);
+        ++sent;
+        changed.notify_one();
+    }
+
+    lock.unlock();
+
+    if (stopped)
+        return false;
+
+    batch.tokens.clear();
+    batch.errors.clear();
+    batch.last = false;
+
+    return true;
+}
+
+void ThreadedLexer::receive() {
+    std::unique_lock<std::mutex> lock{mutex};
+
+    wait(lock, [this] { return sent != received; });
+
+    std::swap(current, queue[received % queue.size()]);
+    ++received;
+    changed.notify_one();
+
+    lock.unlock();
+
+    nextToken = 0;
+    nextError = 0;
+}
+
+void ThreadedLexer::stop() {
+    finished = true;
+
+    if (!thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+        changed.notify_one();
+    }
+
+    thread.join();
+}
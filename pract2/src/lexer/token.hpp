@@ -1,7 +1,10 @@
 #ifndef TOKEN_HPP
 #define TOKEN_HPP
 
-#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
 
 enum class TokenType {
     // Keywords
@@ -43,9 +46,54 @@ enum class TokenType {
     RIGHT_BRACKET, // ]
     COMMA,         // ,
     SEMICOLON,     // ;
+
+    // Marks the end of the input. Never produced by the lexer, but the parser
+    // returns it when peeking past the last token.
+    END_OF_FILE,
+};
+
+// Names of the token types, in the order of TokenType.
+inline constexpr std::string_view tokenTypeNames[] = {
+    "RETURN",
+    "IF",
+    "ELSE",
+    "WHILE",
+    "FOR",
+    "IDENTIFIER",
+    "INT_LITERAL",
+    "FLOAT_LITERAL",
+    "STRING_LITERAL",
+    "EQUALS",
+    "EQUALS_EQUALS",
+    "BANG_EQUALS",
+    "LESS_THAN",
+    "LESS_THAN_EQUALS",
+    "GREATER_THAN",
+    "GREATER_THAN_EQUALS",
+    "PLUS",
+    "MINUS",
+    "STAR",
+    "SLASH",
+    "CARET",
+    "PERCENT",
+    "LEFT_PAREN",
+    "RIGHT_PAREN",
+    "LEFT_BRACE",
+    "RIGHT_BRACE",
+    "LEFT_BRACKET",
+    "RIGHT_BRACKET",
+    "COMMA",
+    "SEMICOLON",
+    "END_OF_FILE",
 };
 
-std::string token_type_to_string(TokenType type);
+static_assert(std::size(tokenTypeNames) ==
+                  static_cast<std::size_t>(TokenType::END_OF_FILE) + 1,
+              "Every token type needs a name!");
+
+constexpr std::string_view token_type_to_string(TokenType type) {
+    return tokenTypeNames[static_cast<std::size_t>(type)];
+}
 
 struct Location {
     Location() : line(0), col(0) {}
@@ -54,15 +102,43 @@ struct Location {
     unsigned int col;
 };
 
+// Handle to an interned identifier in an IdentifierTable. Identifiers with the
+// same spelling get the same handle, so they can be compared by handle instead
+// of by spelling.
+struct Identifier {
+    static constexpr std::uint32_t invalid = ~std::uint32_t{0};
+
+    std::uint32_t id = invalid;
+
+    bool isValid() const { return id != invalid; }
+    bool operator==(Identifier other) const { return id == other.id; }
+    bool operator!=(Identifier other) const { return id != other.id; }
+};
+
+// NOTE: The lexeme is a view into the source buffer of the lexer, so tokens
+// must not outlive the buffer they were lexed from. The location of a token is
+// not stored, but computed from its lexeme by a SourceManager when needed.
 struct Token {
-    Token(TokenType type, Location begin, Location end,
-          const std::string &lexeme)
-        : type(type), begin(begin), end(end), lexeme(lexeme) {}
+    Token(TokenType type, std::string_view lexeme,
+          Identifier identifier = Identifier{})
+        : type(type), identifier(identifier), lexeme(lexeme) {}
 
     TokenType type;
-    Location begin;
-    Location end;
-    std::string lexeme;
+
+    // Data that depends on the type of the token. Only the member that belongs
+    // to the type is valid.
+    union {
+        // The interned spelling, for IDENTIFIER tokens.
+        Identifier identifier;
+
+        // The decoded value, for INT_LITERAL tokens.
+        std::int32_t intValue;
+
+        // The decoded value, for FLOAT_LITERAL tokens.
+        float floatValue;
+    };
+
+    std::string_view lexeme;
 };
 
 #endif /* end of include guard: TOKEN_HPP */
@@ -0,0 +1,86 @@
+#ifndef TOKENBUFFER_HPP
+#define TOKENBUFFER_HPP
+
+#include "lexer/token.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Compact storage for a complete token stream.
+//
+// Instead of an array of Tokens, the buffer keeps the token types, the offsets
+// of the lexemes in the source buffer, their lengths and their type-dependent
+// data (the interned identifier or the value of a literal) in four separate
+// dense arrays, i.e. 13 bytes per token. Tokens are reconstructed on access.
+// Locations can be computed from the offsets with a SourceManager.
+class TokenBuffer {
+  public:
+    // NOTE: The buffer only stores offsets into the source, so the source
+    // must outlive the buffer.
+    TokenBuffer(std::string_view source);
+
+    // Appends a token, whose lexeme must point into the source.
+    void push_back(const Token &token);
+
+    // Appends the tokens of other, starting at index from. Both buffers must
+    // refer to the same source.
+    void append(const TokenBuffer &other, std::size_t from = 0);
+
+    // Replaces the tokens in [first, last) by the tokens of other, after an
+    // edit of the source that moved everything behind the replaced tokens by
+    // delta bytes. The offsets of the tokens after last are adjusted, and the
+    // buffer refers to the source of other from now on.
+    void replace(std::size_t first, std::size_t last, const TokenBuffer &other,
+                 std::int64_t delta);
+
+    // Reserves memory for the given number of tokens.
+    void reserve(std::size_t count);
+
+    // Removes the tokens from index count on.
+    void truncate(std::size_t count);
+
+    std::size_t size() const;
+    bool empty() const;
+
+    // Reconstructs the token at the given index.
+    Token operator[](std::size_t index) const;
+
+    TokenType getType(std::size_t index) const;
+    std::uint32_t getOffset(std::size_t index) const;
+    std::uint32_t getLength(std::size_t index) const;
+
+    // Returns the interned identifier of the IDENTIFIER token at the given
+    // index.
+    Identifier getIdentifier(std::size_t index) const;
+
+    // Returns the data of the token at the given index that depends on its
+    // type, as it is stored: the interned identifier, or the bits of the value
+    // of a literal.
+    std::uint32_t getData(std::size_t index) const;
+
+    // Replaces the interned identifier of the IDENTIFIER token at the given
+    // index, e.g. to move it to a different IdentifierTable.
+    void setIdentifier(std::size_t index, Identifier identifier);
+
+    // Returns the source buffer the tokens refer to.
+    std::string_view getSource() const;
+
+    // Creates a token from its stored form, with data as returned by
+    // getData().
+    static Token makeToken(TokenType type, std::string_view lexeme,
+                           std::uint32_t data);
+
+  private:
+    std::string_view source;
+
+    std::vector<std::uint8_t> types;
+    std::vector<std::uint32_t> offsets;
+    std::vector<std::uint32_t> lengths;
+
+    // The data of Token that depends on the type, e.g. Token::identifier.
+    std::vector<std::uint32_t> data;
+};
+
+#endif /* end of include guard: TOKENBUFFER_HPP */
@@ -0,0 +1,50 @@
+#include "lexer/tokendumper.hpp"
+
+#include <fmt/compile.h>
+#include <iterator>
+#include <string_view>
+
+TokenDumper::TokenDumper(const SourceManager &sourceManager, std::FILE *out)
+    : sourceManager(sourceManager), out(out) {}
+
+TokenDumper::~TokenDumper() { flush(); }
+
+void TokenDumper::dump(const Token &token) {
+    Location begin = sourceManager.getBeginLocation(token);
+    Location end = sourceManager.getEndLocation(token);
+
+    // Four 32-bit numbers and the separators always fit.
+    char location[64];
+    char *locationEnd = fmt::format_to(location, FMT_COMPILE("{}:{} -> {}:{}"),
+                                       begin.line, begin.col, end.line, end.col);
+
+    appendColumn(std::string_view(location, locationEnd - location));
+    appendColumn(token.lexeme);
+    appendColumn(token_type_to_string(token.type));
+    buffer.push_back('\n');
+
+    if (buffer.size() >= flushThreshold)
+        flush();
+}
+
+void TokenDumper::flush() {
+    std::fwrite(buffer.data(), 1, buffer.size(), out);
+    buffer.clear();
+}
+
+void TokenDumper::appendColumn(std::string_view text) {
+    // fmt pads to the display width, which differs from the size in bytes
+    // for non-ASCII text. Leave that case to fmt, to keep the same output.
+    for (char c : text) {
+        if (static_cast<unsigned char>(c) >= 0x80) {
+            fmt::format_to(std::back_inserter(buffer), "{:{}}", text,
+                           columnWidth);
+            return;
+        }
+    }
+
+    buffer.append(text.data(), text.data() + text.size());
+
+    for (std::size_t i = text.size(); i < columnWidth; ++i)
+        buffer.push_back(' ');
+}
@@ -0,0 +1,45 @@
+#ifndef TOKENDUMPER_HPP
+#define TOKENDUMPER_HPP
+
+#include "lexer/sourcemanager.hpp"
+#include "lexer/token.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <fmt/format.h>
+#include <string_view>
+
+// Writes the token dump of the drivers: one line per token, with its location,
+// lexeme and type in columns of 20 characters.
+//
+// Lines are formatted into one large buffer, which is written out whenever it
+// grows beyond a threshold and when the dumper is flushed or destroyed. The
+// columns are padded by hand, since fmt's width computation dominates the time
+// of a dump otherwise.
+class TokenDumper {
+  public:
+    TokenDumper(const SourceManager &sourceManager, std::FILE *out = stdout);
+    ~TokenDumper();
+
+    TokenDumper(const TokenDumper &) = delete;
+    TokenDumper &operator=(const TokenDumper &) = delete;
+
+    void dump(const Token &token);
+
+    // Writes the buffered output.
+    void flush();
+
+  private:
+    static constexpr std::size_t flushThreshold = 1 << 16;
+    static constexpr std::size_t columnWidth = 20;
+
+    const SourceManager &sourceManager;
+    std::FILE *out;
+
+    fmt::memory_buffer buffer;
+
+    // Appends text, padded with spaces to columnWidth.
+    void appendColumn(std::string_view text);
+};
+
+#endif /* end of include guard: TOKENDUMPER_HPP */
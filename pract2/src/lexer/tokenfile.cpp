@@ -0,0 +1,212 @@
+#include "lexer/tokenfile.hpp"
+
+#include "llvm/Support/EndianStream.h"
+#include "llvm/Support/MathExtras.h"
+
+#include <cstring>
+
+namespace {
+
+using llvm::support::ulittle32_t;
+
+// The first bytes of a token file. The non-ASCII first byte and the line ends
+// catch files that were transferred as text.
+constexpr char magic[8] = {'\x89', 'M', 'C', 'T', 'O', 'K', '\r', '\n'};
+
+struct Header {
+    char magic[8];
+    ulittle32_t version;
+    ulittle32_t tokenCount;
+    ulittle32_t identifierCount;
+    ulittle32_t sourceSize;
+    ulittle32_t spellingSize;
+    ulittle32_t reserved;
+};
+
+static_assert(sizeof(Header) == 32, "Header must not be padded!");
+
+// Offsets of the sections in a token file, and its total size.
+struct Layout {
+    std::uint64_t source;
+    std::uint64_t types;
+    std::uint64_t offsets;
+    std::uint64_t lengths;
+    std::uint64_t data;
+    std::uint64_t spellingOffsets;
+    std::uint64_t spellings;
+    std::uint64_t end;
+};
+
+Layout computeLayout(std::uint64_t tokenCount, std::uint64_t identifierCount,
+                     std::uint64_t sourceSize, std::uint64_t spellingSize) {
+    Layout layout;
+    layout.source = sizeof(Header);
+    layout.types = llvm::alignTo(layout.source + sourceSize, 4);
+    layout.offsets = llvm::alignTo(layout.types + tokenCount, 4);
+    layout.lengths = layout.offsets + 4 * tokenCount;
+    layout.data = layout.lengths + 4 * tokenCount;
+    layout.spellingOffsets = layout.data + 4 * tokenCount;
+    layout.spellings = layout.spellingOffsets + 4 * (identifierCount + 1);
+    layout.end = llvm::alignTo(layout.spellings + spellingSize, 4);
+
+    return layout;
+}
+
+// Writes zeros up to the given offset, which must be at most 3 bytes ahead.
+void padTo(llvm::raw_ostream &out, std::uint64_t written,
+           std::uint64_t offset) {
+    out.write_zeros(static_cast<unsigned>(offset - written));
+}
+
+llvm::Error corrupt(const char *what) {
+    return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                   "corrupt token file: %s", what);
+}
+
+} // namespace
+
+bool TokenFile::isTokenFile(std::string_view buffer) {
+    return buffer.size() >= sizeof(magic) &&
+           std::memcmp(buffer.data(), magic, sizeof(magic)) == 0;
+}
+
+void TokenFile::write(llvm::raw_ostream &out, const TokenBuffer &tokens,
+                      const IdentifierTable &identifiers) {
+    llvm::support::endian::Writer writer(out, llvm::support::little);
+
+    std::string_view source = tokens.getSource();
+
+    std::uint32_t spellingSize = 0;
+    for (std::uint32_t id = 0; id < identifiers.size(); ++id)
+        spellingSize += identifiers.getSpelling(Identifier{id}).size();
+
+    Layout layout = computeLayout(tokens.size(), identifiers.size(),
+                                  source.size(), spellingSize);
+
+    out.write(magic, sizeof(magic));
+    writer.write<std::uint32_t>(version);
+    writer.write<std::uint32_t>(tokens.size());
+    writer.write<std::uint32_t>(identifiers.size());
+    writer.write<std::uint32_t>(source.size());
+    writer.write<std::uint32_t>(spellingSize);
+    writer.write<std::uint32_t>(0);
+
+    out.write(source.data(), source.size());
+    padTo(out, layout.source + source.size(), layout.types);
+
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+        writer.write<std::uint8_t>(
+            static_cast<std::uint8_t>(tokens.getType(i)));
+    padTo(out, layout.types + tokens.size(), layout.offsets);
+
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+        writer.write<std::uint32_t>(tokens.getOffset(i));
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+        writer.write<std::uint32_t>(tokens.getLength(i));
+    for (std::size_t i = 0; i < tokens.size(); ++i)
+        writer.write<std::uint32_t>(tokens.getData(i));
+
+    std::uint32_t spellingOffset = 0;
+    writer.write<std::uint32_t>(spellingOffset);
+    for (std::uint32_t id = 0; id < identifiers.size(); ++id) {
+        spellingOffset += identifiers.getSpelling(Identifier{id}).size();
+        writer.write<std::uint32_t>(spellingOffset);
+    }
+
+    for (std::uint32_t id = 0; id < identifiers.size(); ++id) {
+        std::string_view spelling = identifiers.getSpelling(Identifier{id});
+        out.write(spelling.data(), spelling.size());
+    }
+    padTo(out, layout.spellings + spellingSize, layout.end);
+}
+
+llvm::Expected<TokenFile> TokenFile::read(std::string_view buffer) {
+    if (!isTokenFile(buffer))
+        return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                       "not a token file");
+
+    if (buffer.size() < sizeof(Header))
+        return corrupt("truncated header");
+
+    const auto *header = reinterpret_cast<const Header *>(buffer.data());
+
+    if (header->version != version)
+        return llvm::createStringError(
+            llvm::inconvertibleErrorCode(),
+            "unsupported token file version %u (expected %u)",
+            static_cast<std::uint32_t>(header->version), version);
+
+    Layout layout = computeLayout(header->tokenCount, header->identifierCount,
+                                  header->sourceSize, header->spellingSize);
+
+    if (buffer.size() != layout.end)
+        return corrupt("size does not match the header");
+
+    TokenFile file;
+
+    const char *base = buffer.data();
+    file.source = buffer.substr(layout.source, header->sourceSize);
+    file.tokenCount = header->tokenCount;
+    file.types = reinterpret_cast<const std::uint8_t *>(base + layout.types);
+    file.offsets = reinterpret_cast<const ulittle32_t *>(base + layout.offsets);
+    file.lengths = reinterpret_cast<const ulittle32_t *>(base + layout.lengths);
+    file.data = reinterpret_cast<const ulittle32_t *>(base + layout.data);
+    file.identifierCount = header->identifierCount;
+    file.spellingOffsets =
+        reinterpret_cast<const ulittle32_t *>(base + layout.spellingOffsets);
+    file.spellings = base + layout.spellings;
+
+    // Check everything that the accessors rely on once, so that they do not
+    // have to.
+    for (std::size_t i = 0; i < file.tokenCount; ++i) {
+        if (file.types[i] >=
+            static_cast<std::uint8_t>(TokenType::END_OF_FILE))
+            return corrupt("invalid token type");
+
+        if (std::uint64_t{file.offsets[i]} + file.lengths[i] >
+            file.source.size())
+            return corrupt("token outside of the source");
+
+        if (file.types[i] == static_cast<std::uint8_t>(TokenType::IDENTIFIER) &&
+            file.data[i] >= file.identifierCount)
+            return corrupt("invalid identifier");
+    }
+
+    if (file.spellingOffsets[0] != 0 ||
+        file.spellingOffsets[file.identifierCount] != header->spellingSize)
+        return corrupt("invalid identifier table");
+
+    for (std::size_t id = 0; id < file.identifierCount; ++id)
+        if (file.spellingOffsets[id] > file.spellingOffsets[id + 1])
+            return corrupt("invalid identifier table");
+
+    return file;
+}
+
+std::optional<Token> TokenFile::next() {
+    if (position == tokenCount)
+        return std::nullopt;
+
+    return (*this)[position++];
+}
+
+bool TokenFile::hadError() const { return false; }
+
+std::size_t TokenFile::size() const { return tokenCount; }
+
+Token TokenFile::operator[](std::size_t index) const {
+    return TokenBuffer::makeToken(static_cast<TokenType>(types[index]),
+                                  source.substr(offsets[index], lengths[index]),
+                                  data[index]);
+}
+
+std::string_view TokenFile::getSource() const { return source; }
+
+std::size_t TokenFile::getIdentifierCount() const { return identifierCount; }
+
+std::string_view TokenFile::getSpelling(Identifier identifier) const {
+    std::uint32_t begin = spellingOffsets[identifier.id];
+    std::uint32_t end = spellingOffsets[identifier.id + 1];
+
+    return std::string_view(spellings + begin, end - begin);
+}
@@ -0,0 +1,95 @@
+#include "lexer/utf8.hpp"
+#include "lexer/scanner.hpp"
+
+namespace utf8 {
+
+std::size_t sequenceLength(const char *p, const char *end) {
+    auto byte = [p](std::size_t i) { return static_cast<unsigned char>(p[i]); };
+
+    unsigned char lead = byte(0);
+
+    if (lead < 0x80)
+        return 1;
+
+    std::size_t length;
+
+    // The range of the second byte rules out overlong encodings, surrogates
+    // and code points beyond U+10FFFF.
+    unsigned char low = 0x80, high = 0xBF;
+
+    if (lead < 0xC2) {
+        return 0;
+    } else if (lead < 0xE0) {
+        length = 2;
+    } else if (lead < 0xF0) {
+        length = 3;
+        if (lead == 0xE0)
+            low = 0xA0;
+        else if (lead == 0xED)
+            high = 0x9F;
+    } else if (lead < 0xF5) {
+        length = 4;
+        if (lead == 0xF0)
+            low = 0x90;
+        else if (lead == 0xF4)
+            high = 0x8F;
+    } else {
+        return 0;
+    }
+
+    if (static_cast<std::size_t>(end - p) < length)
+        return 0;
+
+    if (byte(1) < low || byte(1) > high)
+        return 0;
+
+    for (std::size_t i = 2; i < length; ++i)
+        if (!isContinuation(p[i]))
+            return 0;
+
+    return length;
+}
+
+std::size_t invalidLength(const char *p, const char *end) {
+    const char *q = p + 1;
+
+    while (q != end && isContinuation(*q))
+        ++q;
+
+    return q - p;
+}
+
+const char *findInvalid(const char *p, const char *end) {
+    while ((p = scanner::skip<scanner::AsciiChars>(p, end)) != end) {
+        // Check the run of non-ASCII characters one sequence at a time.
+        do {
+            std::size_t length = sequenceLength(p, end);
+
+            if (length == 0)
+                return p;
+
+            p += length;
+        } while (p != end && !scanner::isAscii(*p));
+    }
+
+    return end;
+}
+
+std::size_t countCharacters(const char *p, const char *end) {
+    std::size_t count = 0;
+
+    while (p != end) {
+        const char *ascii = scanner::skip<scanner::AsciiChars>(p, end);
+        count += ascii - p;
+        p = ascii;
+
+        for (; p != end && !scanner::isAscii(*p); ++count) {
+            std::size_t length = sequenceLength(p, end);
+            p += length ? length : 1;
+        }
+    }
+
+    return count;
+}
+
+} // namespace utf8
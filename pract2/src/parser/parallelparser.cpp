@@ -0,0 +1,238 @@
+#include "parser/parallelparser.hpp"
+#include "ast/visitor.hpp"
+#include "parser/parser.hpp"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Threading.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <thread>
+
+using namespace ast;
+
+namespace {
+
+// Tokens that were read before, as a stream for the Parser.
+class TokenArray final : public TokenSource {
+  public:
+    TokenArray(std::vector<llvm::ArrayRef<Token>> parts, bool errorFlag)
+        : parts(std::move(parts)), errorFlag(errorFlag) {}
+
+    std::optional<Token> next() override {
+        while (part < parts.size() && position == parts[part].size()) {
+            ++part;
+            position = 0;
+        }
+
+        if (part == parts.size())
+            return std::nullopt;
+
+        return parts[part][position++];
+    }
+
+    bool hadError() const override { return errorFlag; }
+
+  private:
+    // The tokens, in a number of consecutive parts.
+    std::vector<llvm::ArrayRef<Token>> parts;
+    std::size_t part = 0;
+    std::size_t position = 0;
+
+    bool errorFlag;
+};
+
+// Adds offset to the ids of a node and all of its descendants.
+struct IdShifter : public Visitor<IdShifter> {
+    explicit IdShifter(unsigned offset) : offset(offset) {}
+
+    unsigned offset;
+
+#define SHIFT(Node)                                                            \
+    void visit##Node(Node &node) {                                             \
+        node.id += offset;                                                     \
+        Visitor::visit##Node(node);                                            \
+    }
+
+    SHIFT(Program)
+    SHIFT(FuncDecl)
+    SHIFT(EmptyStmt)
+    SHIFT(IfStmt)
+    SHIFT(WhileStmt)
+    SHIFT(ReturnStmt)
+    SHIFT(ExprStmt)
+    SHIFT(VarDecl)
+    SHIFT(ArrayDecl)
+    SHIFT(CompoundStmt)
+    SHIFT(BinaryOpExpr)
+    SHIFT(UnaryOpExpr)
+    SHIFT(IntLiteral)
+    SHIFT(FloatLiteral)
+    SHIFT(StringLiteral)
+    SHIFT(VarRefExpr)
+    SHIFT(ArrayRefExpr)
+    SHIFT(FuncCallExpr)
+
+#undef SHIFT
+};
+
+// A part of the input that is parsed on its own.
+struct Chunk {
+    void parse() {
+        TokenArray source{{tokens}, false};
+
+        // The errors are not reported, since the input is parsed again if
+        // there are any.
+        DiagnosticEngine diagnostics;
+
+        Parser parser{source, diagnostics, *context};
+        program = static_cast<Ptr<Program>>(parser.parse());
+        errorFlag = parser.hadError();
+    }
+
+    // Makes the ids of the FuncDecls, which start at 0, start at firstId.
+    void renumber() {
+        IdShifter shifter{firstId};
+
+        for (Ptr<FuncDecl> decl : program->declarations)
+            shifter.visit(*decl);
+    }
+
+    // Returns the number of nodes of the FuncDecls, i.e. without the Program
+    // that contains them, which is created last.
+    unsigned getNodeCount() const { return context->getNextId() - 1; }
+
+    std::vector<Token> tokens;
+
+    std::unique_ptr<ASTContext> context = std::make_unique<ASTContext>();
+    Ptr<Program> program = nullptr;
+    bool errorFlag = false;
+
+    // The id of the first node in the complete AST.
+    unsigned firstId = 0;
+};
+
+using ChunkList = std::vector<std::unique_ptr<Chunk>>;
+
+// Calls work for every chunk, on a pool of threads.
+template <typename Function>
+void forEachChunk(ChunkList &chunks, unsigned threads, Function work) {
+    // Every worker repeatedly takes the next chunk that nobody took yet.
+    std::atomic<std::size_t> nextChunk{0};
+    auto worker = [&chunks, &nextChunk, &work] {
+        std::size_t index;
+        while ((index = nextChunk.fetch_add(1)) < chunks.size())
+            work(*chunks[index]);
+    };
+
+    unsigned workerCount =
+        threads ? threads : llvm::hardware_concurrency().compute_thread_count();
+    workerCount = std::min<std::size_t>(workerCount, chunks.size());
+
+    // The calling thread is one of the workers.
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < workerCount; ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (std::thread &thread : workers)
+        thread.join();
+}
+
+// Reads all tokens, and splits them into chunks of complete FuncDecls of at
+// least chunkSize tokens (except for the last chunk), by matching braces: a
+// FuncDecl ends at the "}" that closes its first "{".
+ChunkList read(TokenSource &tokens, std::size_t chunkSize) {
+    ChunkList chunks;
+    chunks.push_back(std::make_unique<Chunk>());
+
+    // Number of braces that are open.
+    unsigned depth = 0;
+
+    while (std::optional<Token> token = tokens.next()) {
+        std::vector<Token> &chunkTokens = chunks.back()->tokens;
+        chunkTokens.push_back(*token);
+
+        if (token->type == TokenType::LEFT_BRACE) {
+            ++depth;
+        } else if (token->type == TokenType::RIGHT_BRACE && depth > 0) {
+            // The end of a FuncDecl. If the braces do not match, the chunks
+            // have syntax errors, so where they are split does not matter.
+            if (--depth == 0 && chunkTokens.size() >= chunkSize)
+                chunks.push_back(std::make_unique<Chunk>());
+        }
+    }
+
+    if (chunks.back()->tokens.empty())
+        chunks.pop_back();
+
+    return chunks;
+}
+
+} // namespace
+
+ParallelParser::ParallelParser(TokenSource &tokens,
+                               DiagnosticEngine &diagnostics,
+                               ASTContext &context, unsigned threads,
+                               std::size_t chunkSize)
+    : tokens(tokens), diagnostics(diagnostics), context(context),
+      threads(threads), chunkSize(std::max<std::size_t>(chunkSize, 1)) {}
+
+Ptr<Base> ParallelParser::parse() {
+    ChunkList chunks = read(tokens, chunkSize);
+
+    // With lexer errors, the sequential Parser still returns a partial AST,
+    // so leave that to it.
+    bool parseAgain = tokens.hadError();
+
+    if (!parseAgain) {
+        forEachChunk(chunks, threads, [](Chunk &chunk) { chunk.parse(); });
+
+        parseAgain = std::any_of(chunks.begin(), chunks.end(),
+                                 [](const std::unique_ptr<Chunk> &chunk) {
+                                     return chunk->errorFlag;
+                                 });
+    }
+
+    if (parseAgain) {
+        std::vector<llvm::ArrayRef<Token>> parts;
+        for (std::unique_ptr<Chunk> &chunk : chunks) {
+            chunk->context.reset();
+            parts.push_back(chunk->tokens);
+        }
+
+        TokenArray source{std::move(parts), tokens.hadError()};
+        Parser parser{source, diagnostics, context};
+
+        Ptr<Base> program = parser.parse();
+        errorFlag = parser.hadError();
+
+        return program;
+    }
+
+    // Number the nodes as if they were created in order, in context.
+    unsigned nextId = context.getNextId();
+    for (std::unique_ptr<Chunk> &chunk : chunks) {
+        chunk->firstId = nextId;
+        nextId += chunk->getNodeCount();
+    }
+
+    forEachChunk(chunks, threads, [](Chunk &chunk) { chunk.renumber(); });
+
+    llvm::SmallVector<Ptr<FuncDecl>, 16> decls;
+
+    for (std::unique_ptr<Chunk> &chunk : chunks) {
+        decls.append(chunk->program->declarations.begin(),
+                     chunk->program->declarations.end());
+
+        context.reserveIds(chunk->getNodeCount());
+        context.adopt(std::move(*chunk->context));
+    }
+
+    return context.create<Program>(context.createList<Ptr<FuncDecl>>(decls));
+}
+
+bool ParallelParser::hadError() const { return errorFlag; }
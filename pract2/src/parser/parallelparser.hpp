@@ -0,0 +1,56 @@
+#ifndef PARALLELPARSER_HPP
+#define PARALLELPARSER_HPP
+
+#include "ast/ast.hpp"
+#include "ast/astcontext.hpp"
+#include "lexer/diagnosticengine.hpp"
+#include "lexer/token.hpp"
+#include "lexer/tokensource.hpp"
+
+#include <cstddef>
+
+// Parses a Program on multiple threads.
+//
+// All tokens are read from the source up front (so they are all in memory at
+// once) and split into chunks of complete FuncDecls of roughly chunkSize
+// tokens, by matching braces: a FuncDecl ends at the "}" that closes its
+// first "{". A pool of worker threads parses the chunks independently, each
+// into an ASTContext of its own. The result is identical to the one of the
+// sequential Parser:
+//
+// - The FuncDecls of the chunks are concatenated in source order.
+// - The ids of the nodes of each chunk are shifted to follow those of the
+//   chunks before it, and the arenas are adopted by context.
+// - If a chunk has a syntax error, or the tokens have lexer errors, the chunks
+//   are thrown away and the input is parsed again by a sequential Parser, so
+//   that error recovery and diagnostics do not depend on the split.
+//
+// A chunk that parses without errors consists of complete FuncDecls, and the
+// parser never looks past the "}" that ends a FuncDecl, so the sequential
+// Parser would make the same decisions for it.
+class ParallelParser {
+  public:
+    static constexpr std::size_t defaultChunkSize = 1 << 16;
+
+    // The nodes of the AST are allocated in context, and parser errors are
+    // reported to diagnostics. The number of threads defaults to the number
+    // of hardware threads.
+    ParallelParser(TokenSource &tokens, DiagnosticEngine &diagnostics,
+                   ast::ASTContext &context, unsigned threads = 0,
+                   std::size_t chunkSize = defaultChunkSize);
+
+    ast::Ptr<ast::Base> parse();
+    bool hadError() const;
+
+  private:
+    TokenSource &tokens;
+    DiagnosticEngine &diagnostics;
+    ast::ASTContext &context;
+
+    unsigned threads;
+    std::size_t chunkSize;
+
+    bool errorFlag = false;
+};
+
+#endif /* end of include guard: PARALLELPARSER_HPP */
@@ -1,51 +1,173 @@
 /* https://dodona.be/en/courses/4707/series/53371/activities/1693496324 */
 
 #include "parser/parser.hpp"
+#include "ast/stack.hpp"
 
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/Debug.h"
-#include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <array>
+#include <cassert>
+#include <cstddef>
 #include <fmt/core.h>
 #include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
 
 using namespace ast;
-using std::make_shared;
 
 #define DEBUG_TYPE "parser"
 
+namespace {
+
+enum class Associativity { Left, Right, None };
+
+struct BinaryOperator {
+    // Operators with a higher precedence bind tighter. A precedence of 0 means
+    // that the token is not a binary operator.
+    unsigned precedence = 0;
+    Associativity associativity = Associativity::Left;
+};
+
+constexpr unsigned lowestPrecedence = 1;
+
+// The unary + and - bind tighter than the multiplicative operators, but less
+// tight than ^, so -2 ^ 3 is -(2 ^ 3).
+constexpr unsigned unaryPrecedence = 6;
+
+constexpr std::array<BinaryOperator, std::size(tokenTypeNames)>
+makeBinaryOperators() {
+    std::array<BinaryOperator, std::size(tokenTypeNames)> table{};
+
+    auto set = [&table](TokenType type, unsigned precedence,
+                        Associativity associativity) {
+        table[static_cast<std::size_t>(type)] = {precedence, associativity};
+    };
+
+    set(TokenType::EQUALS, 1, Associativity::Right);
+    set(TokenType::EQUALS_EQUALS, 2, Associativity::None);
+    set(TokenType::BANG_EQUALS, 2, Associativity::None);
+    set(TokenType::LESS_THAN, 3, Associativity::None);
+    set(TokenType::LESS_THAN_EQUALS, 3, Associativity::None);
+    set(TokenType::GREATER_THAN, 3, Associativity::None);
+    set(TokenType::GREATER_THAN_EQUALS, 3, Associativity::None);
+    set(TokenType::PLUS, 4, Associativity::Left);
+    set(TokenType::MINUS, 4, Associativity::Left);
+    set(TokenType::STAR, 5, Associativity::Left);
+    set(TokenType::SLASH, 5, Associativity::Left);
+    set(TokenType::PERCENT, 5, Associativity::Left);
+    set(TokenType::CARET, 7, Associativity::Right);
+
+    return table;
+}
+
+// The binary operators of MicroC, indexed by token type.
+constexpr std::array<BinaryOperator, std::size(tokenTypeNames)>
+    binaryOperators = makeBinaryOperators();
+
+constexpr BinaryOperator getBinaryOperator(TokenType type) {
+    return binaryOperators[static_cast<std::size_t>(type)];
+}
+
+static_assert(getBinaryOperator(TokenType::CARET).precedence >
+                      unaryPrecedence &&
+                  getBinaryOperator(TokenType::STAR).precedence <
+                      unaryPrecedence,
+              "Unary operators bind between ^ and *!");
+
+} // namespace
+
 struct Parser::Implementation {
-    Implementation(const std::vector<Token> &tokens);
+    Implementation(TokenSource &tokens, DiagnosticEngine &diagnostics,
+                   ASTContext &context);
     ast::Ptr<ast::Base> parse();
     bool hadError() const;
 
-    // The list of tokens that was created by the lexer.
-    std::vector<Token> tokens;
+    // The lexer, or other source, that produces the tokens.
+    TokenSource &tokens;
+
+    // Receives the errors.
+    DiagnosticEngine &diagnostics;
+
+    // Owns the nodes of the AST.
+    ASTContext &context;
+
+    // Ring buffer with the tokens that have been lexed but not consumed yet.
+    // The parser never looks more than three tokens ahead.
+    static constexpr std::size_t lookaheadSize = 3;
+    std::array<std::optional<Token>, lookaheadSize> lookahead;
+    std::size_t lookaheadBegin = 0;
+    std::size_t lookaheadCount = 0;
+
+    // The last token that was consumed, used to report errors at the end of
+    // the input.
+    std::optional<Token> previous;
+
+    // Returned when peeking past the last token, so that the parsing functions
+    // can check the type of the next token without checking for the end of
+    // the input first.
+    const Token endOfFile{TokenType::END_OF_FILE, std::string_view{}};
+
+    // Set when a syntax error is found, until the parser has resynchronised.
+    // While it is set, the parsing functions return nullptr as soon as they
+    // can, so that the error unwinds to where the parser can recover.
+    bool failed = false;
 
-    // Iterator to the current token.
-    std::vector<Token>::const_iterator current;
+    // Set while the error unwinds to the next FuncDecl, so that the blocks it
+    // passes through do not try to recover.
+    bool skippingFuncDecl = false;
 
     // Flag that is set when an error occurs.
     bool errorFlag = false;
 
+    // Pulls tokens from the lexer until the lookahead buffer contains at least
+    // count tokens, or the input runs out. Returns true if it contains at
+    // least count tokens.
+    bool fill(std::size_t count);
+
+    // Returns the token at the given position in the lookahead buffer.
+    const Token &lookaheadAt(std::size_t index) const;
+
     // Returns true if the entire input is processed.
-    bool isAtEnd() const;
+    bool isAtEnd();
 
     // Advances the parser by one token.
     void advance();
 
-    // Peeks the next token in the input stream.
-    Token peek() const;
+    // Peeks the next token in the input stream, or returns an END_OF_FILE
+    // token at the end of the input. The reference is valid until the parser
+    // advances.
+    const Token &peek();
 
-    // Peeks two tokens forward in the input stream.
-    Token peekNext() const;
+    // Peeks two tokens forward in the input stream, like peek().
+    const Token &peekNext();
+
+    // Returns true if the next tokens start a FuncDecl, i.e. are two
+    // identifiers followed by "(". This never starts a statement.
+    bool isAtFuncDecl();
 
     // Ensures that the next token is of the given type, returns that token, and
-    // advances the parser.
-    Token eat(TokenType expected, const std::string &errorMessage = "");
+    // advances the parser. Otherwise, reports an error and returns the next
+    // token without advancing. While failed is set, it never advances, so a
+    // run of calls only needs to check failed after the last one.
+    Token eat(TokenType expected, std::string_view errorMessage = {});
+
+    // Reports an error at the current position, and sets failed. The caller
+    // must return nullptr.
+    std::nullptr_t error(std::string message);
 
-    // Reports an error at the current position.
-    ParserException error(const std::string &message) const;
+    // Error recovery: skips the rest of a statement with an error, up to and
+    // including a ";", or up to the "}" that closes the enclosing block.
+    // Blocks are skipped as a whole. Returns false if it stops at the start of
+    // a FuncDecl, the end of the input or the error limit instead.
+    bool skipStatement();
+
+    // Error recovery: skips tokens up to the start of the next FuncDecl, the
+    // end of the input or the error limit.
+    void skipToFuncDecl();
 
     // Parsing functions. Each of these functions corresponds (roughly speaking)
     // to a non-terminal symbol in the grammar.
@@ -66,19 +188,15 @@ struct Parser::Implementation {
     ast::Ptr<ast::ArrayRefExpr> parseArrayRefExpr();
     ast::Ptr<ast::FuncCallExpr> parseFuncCallExpr();
 
-    ast::Ptr<ast::Expr> parseUnaryOpExpr();
-    ast::Ptr<ast::Expr> parseCarret();
-    ast::Ptr<ast::Expr> parseMultiplicative();
-    ast::Ptr<ast::Expr> parseAdditive();
-    ast::Ptr<ast::Expr> parseComparison();
-    ast::Ptr<ast::Expr> parseEquality();
-    ast::Ptr<ast::Expr> parseAssignment();
+    ast::Ptr<ast::Expr> parseBinaryOpExpr(unsigned minPrecedence);
+    ast::Ptr<ast::Expr> parseUnaryOpExpr(unsigned minPrecedence);
 
     // ASSIGNMENT: Declare additional parsing functions here.
 };
 
-Parser::Parser(const std::vector<Token> &tokens) {
-    pImpl = std::make_unique<Implementation>(tokens);
+Parser::Parser(TokenSource &tokens, DiagnosticEngine &diagnostics,
+               ASTContext &context) {
+    pImpl = std::make_unique<Implementation>(tokens, diagnostics, context);
 }
 
 Parser::~Parser() = default;
@@ -87,94 +205,173 @@ ast::Ptr<ast::Base> Parser::parse() { return pImpl->parse(); }
 
 bool Parser::hadError() const { return pImpl->hadError(); }
 
-Parser::Implementation::Implementation(const std::vector<Token> &tokens)
-    : tokens(tokens) {
-    current = std::begin(this->tokens);
-}
+Parser::Implementation::Implementation(TokenSource &tokens,
+                                       DiagnosticEngine &diagnostics,
+                                       ASTContext &context)
+    : tokens(tokens), diagnostics(diagnostics), context(context) {}
 
 Ptr<Base> Parser::Implementation::parse() {
-    try {
-        return parseProgram();
-    }
-
-    catch (ParserException &e) {
-        errorFlag = true;
-        llvm::WithColor::error(llvm::errs(), "parser") << fmt::format(
-            "{}:{}: {}\n", e.token.begin.line, e.token.begin.col, e.what());
-        return nullptr;
-    }
+    return parseProgram();
 }
 
 bool Parser::Implementation::hadError() const { return errorFlag; }
 
-bool Parser::Implementation::isAtEnd() const {
-    return current == std::end(tokens);
-}
+bool Parser::Implementation::fill(std::size_t count) {
+    while (lookaheadCount < count) {
+        std::optional<Token> token = tokens.next();
 
-void Parser::Implementation::advance() {
-    if (!isAtEnd())
-        ++current;
+        if (!token)
+            return false;
+
+        lookahead[(lookaheadBegin + lookaheadCount) % lookaheadSize] = token;
+        ++lookaheadCount;
+    }
+
+    return true;
 }
 
-Token Parser::Implementation::peek() const {
-    if (!isAtEnd())
-        return *current;
-    else
-        throw error("Cannot peak beyond end-of-file!");
+const Token &Parser::Implementation::lookaheadAt(std::size_t index) const {
+    return *lookahead[(lookaheadBegin + index) % lookaheadSize];
 }
 
-Token Parser::Implementation::peekNext() const {
-    auto it = current;
+bool Parser::Implementation::isAtEnd() { return !fill(1); }
 
-    if (it == std::end(tokens))
-        throw error("Cannot peak beyond end-of-file!");
+void Parser::Implementation::advance() {
+    if (!isAtEnd()) {
+        previous = lookahead[lookaheadBegin];
+        lookaheadBegin = (lookaheadBegin + 1) % lookaheadSize;
+        --lookaheadCount;
+    }
+}
 
-    std::advance(it, 1);
+const Token &Parser::Implementation::peek() {
+    if (fill(1))
+        return lookaheadAt(0);
+    else
+        return endOfFile;
+}
 
-    if (it == std::end(tokens))
-        throw error("Cannot peak beyond end-of-file!");
+const Token &Parser::Implementation::peekNext() {
+    if (fill(2))
+        return lookaheadAt(1);
+    else
+        return endOfFile;
+}
 
-    return *it;
+bool Parser::Implementation::isAtFuncDecl() {
+    return peek().type == TokenType::IDENTIFIER &&
+           peekNext().type == TokenType::IDENTIFIER && fill(3) &&
+           lookaheadAt(2).type == TokenType::LEFT_PAREN;
 }
 
-Parser::ParserException
-Parser::Implementation::error(const std::string &message) const {
-    // NOTE: For now, we stop the parser completely when we encounter an error.
-    // A better solution would be to implement some form of error recovery (e.g.
-    // skipping to tokens in the follow set, synchronisation on statement
-    // boundaries, ...)
-    return ParserException(*current, message);
+std::nullptr_t Parser::Implementation::error(std::string message) {
+    // NOTE: Every parsing function checks failed after calling another one,
+    // and returns as well, until the error reaches a function that can
+    // resynchronise: parseCompoundStmt() after the statement, or
+    // parseProgram() at the next FuncDecl.
+    assert(!failed && "Error while unwinding!");
+    failed = true;
+    errorFlag = true;
+
+    // At the end of the input, report the error at the last token.
+    assert((lookaheadCount > 0 || previous) && "Error before the first token!");
+    const Token &token = lookaheadCount > 0 ? lookaheadAt(0) : *previous;
+
+    // Lexer errors take precedence, since the parser errors after them may well
+    // be a consequence of them.
+    if (!tokens.hadError())
+        diagnostics.error("parser", token.lexeme.data(), token.lexeme,
+                          std::move(message));
+
+    return nullptr;
 }
 
 Token Parser::Implementation::eat(TokenType expected,
-                                  const std::string &errorMessage) {
+                                  std::string_view errorMessage) {
+    // Copy the token, since advancing makes room for the next one.
     Token nextToken = peek();
     TokenType actual = nextToken.type;
 
+    if (failed)
+        return nextToken;
+
     if (expected == actual) {
         advance();
         return nextToken;
     }
 
     if (!errorMessage.empty())
-        throw error(errorMessage);
+        error(std::string(errorMessage));
     else
-        throw error(fmt::format("Expected token type '{}', but got '{}'",
-                                token_type_to_string(expected),
-                                token_type_to_string(actual)));
+        error(fmt::format("Expected token type '{}', but got '{}'",
+                          token_type_to_string(expected),
+                          token_type_to_string(actual)));
+
+    return nextToken;
+}
+
+bool Parser::Implementation::skipStatement() {
+    // Number of blocks that were entered while skipping.
+    unsigned depth = 0;
+
+    while (!diagnostics.reachedErrorLimit()) {
+        switch (peek().type) {
+        case TokenType::END_OF_FILE:
+            return false;
+        case TokenType::SEMICOLON:
+            advance();
+            if (depth == 0)
+                return true;
+            break;
+        case TokenType::LEFT_BRACE:
+            advance();
+            ++depth;
+            break;
+        case TokenType::RIGHT_BRACE:
+            if (depth == 0)
+                return true;
+            advance();
+            // A block ends e.g. a while statement.
+            if (--depth == 0)
+                return true;
+            break;
+        default:
+            if (isAtFuncDecl())
+                return false;
+            advance();
+            break;
+        }
+    }
+
+    return false;
+}
+
+void Parser::Implementation::skipToFuncDecl() {
+    while (!isAtEnd() && !isAtFuncDecl() && !diagnostics.reachedErrorLimit())
+        advance();
 }
 
 // program = function_decl*
 Ptr<Program> Parser::Implementation::Implementation::parseProgram() {
     LLVM_DEBUG(llvm::dbgs() << "In parseProgram()\n");
 
-    List<Ptr<FuncDecl>> decls;
+    llvm::SmallVector<Ptr<FuncDecl>, 16> decls;
+
+    // Stop at the error limit, like the lexer.
+    while (!isAtEnd() && !diagnostics.reachedErrorLimit()) {
+        Ptr<FuncDecl> decl = parseFuncDecl();
+
+        if (failed) {
+            failed = false;
+            skippingFuncDecl = false;
+            skipToFuncDecl();
+            continue;
+        }
 
-    while (!isAtEnd()) {
-        decls.push_back(parseFuncDecl());
+        decls.push_back(decl);
     }
 
-    return make_shared<Program>(decls);
+    return context.create<Program>(context.createList<Ptr<FuncDecl>>(decls));
 }
 
 // function_decl = IDENTIFIER IDENTIFIER "(" function_decl_args? ")" "{" stmt*
@@ -186,6 +383,8 @@ Ptr<FuncDecl> Parser::Implementation::parseFuncDecl() {
     Token name = eat(TokenType::IDENTIFIER);
 
     eat(TokenType::LEFT_PAREN);
+    if (failed)
+        return nullptr;
 
     // Parse arguments
     List<Ptr<VarDecl>> arguments;
@@ -195,22 +394,29 @@ Ptr<FuncDecl> Parser::Implementation::parseFuncDecl() {
     }
 
     eat(TokenType::RIGHT_PAREN);
+    if (failed)
+        return nullptr;
+
     Ptr<CompoundStmt> body = parseCompoundStmt();
+    if (failed)
+        return nullptr;
 
-    return make_shared<FuncDecl>(returnType, name, arguments, body);
+    return context.create<FuncDecl>(returnType, name, arguments, body);
 }
 
 // function_decl_args = IDENTIFIER IDENTIFIER ("," IDENTIFIER IDENTIFIER)*
 List<Ptr<VarDecl>> Parser::Implementation::parseFuncDeclArgs() {
     LLVM_DEBUG(llvm::dbgs() << "In parseFuncDeclArgs()\n");
 
-    List<Ptr<VarDecl>> args;
+    llvm::SmallVector<Ptr<VarDecl>, 4> args;
 
     // Add first argument
     Token type = eat(TokenType::IDENTIFIER);
     Token name = eat(TokenType::IDENTIFIER);
+    if (failed)
+        return {};
 
-    args.emplace_back(make_shared<VarDecl>(type, name));
+    args.emplace_back(context.create<VarDecl>(type, name));
 
     // Parse any remaining arguments
     while (peek().type == TokenType::COMMA) {
@@ -218,14 +424,19 @@ List<Ptr<VarDecl>> Parser::Implementation::parseFuncDeclArgs() {
 
         Token type = eat(TokenType::IDENTIFIER);
         Token name = eat(TokenType::IDENTIFIER);
+        if (failed)
+            return {};
 
-        args.emplace_back(make_shared<VarDecl>(type, name));
+        args.emplace_back(context.create<VarDecl>(type, name));
     }
 
-    return args;
+    return context.createList<Ptr<VarDecl>>(args);
 }
 
 // stmt = "for" "(" forinit expr ";" expr ")" stmt
+//      | "if" "(" expr ")" stmt ("else" stmt)?
+//      | "while" "(" expr ")" stmt
+//      | "return" expr? ";"
 //      | exprstmt | vardeclstmt | arrdeclstmt | "{" stmt* "}" | ";"
 // exprstmt = expr ";"
 // vardeclstmt = IDENTIFIER IDENTIFIER ("=" expr)? ";"
@@ -233,14 +444,26 @@ List<Ptr<VarDecl>> Parser::Implementation::parseFuncDeclArgs() {
 Ptr<Stmt> Parser::Implementation::parseStmt() {
     LLVM_DEBUG(llvm::dbgs() << "In parseStmt()\n");
 
+    // Every nested statement passes through here, and so does every nested
+    // expression through parseBinaryOpExpr(). Deep nesting would overflow the
+    // stack, see ast/stack.hpp.
+    if (isStackNearlyExhausted())
+        return runOnNewStack([this] { return parseStmt(); });
+
     if (peek().type == TokenType::IDENTIFIER) {
         // vardeclstmt or arrdeclstmt
 
         if (peekNext().type != TokenType::IDENTIFIER) {
             // Variable ref or array ref
             Ptr<Expr> expression = parseExpr();
+            if (failed)
+                return nullptr;
+
             eat(TokenType::SEMICOLON);
-            return make_shared<ExprStmt>(expression);
+            if (failed)
+                return nullptr;
+
+            return context.create<ExprStmt>(expression);
         }
 
         Token type = eat(TokenType::IDENTIFIER);
@@ -252,8 +475,10 @@ Ptr<Stmt> Parser::Implementation::parseStmt() {
             Ptr<IntLiteral> size = parseIntLiteral();
             eat(TokenType::RIGHT_BRACKET);
             eat(TokenType::SEMICOLON);
+            if (failed)
+                return nullptr;
 
-            return make_shared<ArrayDecl>(type, name, size);
+            return context.create<ArrayDecl>(type, name, size);
         } else {
             // vardeclstmt
             Ptr<Expr> init = nullptr;
@@ -261,11 +486,15 @@ Ptr<Stmt> Parser::Implementation::parseStmt() {
             if (peek().type == TokenType::EQUALS) {
                 eat(TokenType::EQUALS);
                 init = parseExpr();
+                if (failed)
+                    return nullptr;
             }
 
             eat(TokenType::SEMICOLON);
+            if (failed)
+                return nullptr;
 
-            return make_shared<VarDecl>(type, name, init);
+            return context.create<VarDecl>(type, name, init);
         }
     }
 
@@ -277,7 +506,7 @@ Ptr<Stmt> Parser::Implementation::parseStmt() {
     if (peek().type == TokenType::SEMICOLON) {
         // empty statement
         eat(TokenType::SEMICOLON);
-        return make_shared<EmptyStmt>();
+        return context.create<EmptyStmt>();
     }
 
     if (peek().type == TokenType::FOR) {
@@ -286,17 +515,32 @@ Ptr<Stmt> Parser::Implementation::parseStmt() {
         // to handle fors separately in the later phases.
         eat(TokenType::FOR);
         eat(TokenType::LEFT_PAREN);
+        if (failed)
+            return nullptr;
 
         Ptr<Stmt> init = parseForInit();
+        if (failed)
+            return nullptr;
+
         Ptr<Expr> condition = parseExpr();
+        if (failed)
+            return nullptr;
 
         eat(TokenType::SEMICOLON);
+        if (failed)
+            return nullptr;
 
         Ptr<Expr> increment = parseExpr();
+        if (failed)
+            return nullptr;
 
         eat(TokenType::RIGHT_PAREN);
+        if (failed)
+            return nullptr;
 
         Ptr<Stmt> body = parseStmt();
+        if (failed)
+            return nullptr;
 
         // Transform for(init; cond; inc) body
         // to:
@@ -310,28 +554,110 @@ Ptr<Stmt> Parser::Implementation::parseStmt() {
         //      }
         // }
 
-        List<Ptr<Stmt>> bodyCompoundStmts{body};
-        Ptr<Stmt> bodyCompound = make_shared<CompoundStmt>(bodyCompoundStmts);
+        List<Ptr<Stmt>> bodyCompoundStmts =
+            context.createList<Ptr<Stmt>>({body});
+        Ptr<Stmt> bodyCompound =
+            context.create<CompoundStmt>(bodyCompoundStmts);
 
-        Ptr<Stmt> incrementStmt = make_shared<ExprStmt>(increment);
-        List<Ptr<Stmt>> whileBodyStmts{bodyCompound, incrementStmt};
-        Ptr<Stmt> whileBody = make_shared<CompoundStmt>(whileBodyStmts);
+        Ptr<Stmt> incrementStmt = context.create<ExprStmt>(increment);
+        List<Ptr<Stmt>> whileBodyStmts =
+            context.createList<Ptr<Stmt>>({bodyCompound, incrementStmt});
+        Ptr<Stmt> whileBody = context.create<CompoundStmt>(whileBodyStmts);
 
-        Ptr<Stmt> whileStmt = make_shared<WhileStmt>(condition, whileBody);
+        Ptr<Stmt> whileStmt = context.create<WhileStmt>(condition, whileBody);
 
-        List<Ptr<Stmt>> outerBlockStmts{init, whileStmt};
-        Ptr<Stmt> outerBlock = make_shared<CompoundStmt>(outerBlockStmts);
+        List<Ptr<Stmt>> outerBlockStmts =
+            context.createList<Ptr<Stmt>>({init, whileStmt});
+        Ptr<Stmt> outerBlock = context.create<CompoundStmt>(outerBlockStmts);
 
         return outerBlock;
     }
 
     // ASSIGNMENT: Add additional statements here
+    if (peek().type == TokenType::IF) {
+        // if statement
+        // NOTE: An else belongs to the innermost if that does not have one
+        // yet, since that if parses it first.
+        eat(TokenType::IF);
+        eat(TokenType::LEFT_PAREN);
+        if (failed)
+            return nullptr;
+
+        Ptr<Expr> condition = parseExpr();
+        if (failed)
+            return nullptr;
+
+        eat(TokenType::RIGHT_PAREN);
+        if (failed)
+            return nullptr;
+
+        Ptr<Stmt> ifClause = parseStmt();
+        if (failed)
+            return nullptr;
+
+        Ptr<Stmt> elseClause = nullptr;
+
+        if (peek().type == TokenType::ELSE) {
+            eat(TokenType::ELSE);
+            elseClause = parseStmt();
+            if (failed)
+                return nullptr;
+        }
+
+        return context.create<IfStmt>(condition, ifClause, elseClause);
+    }
+
+    if (peek().type == TokenType::WHILE) {
+        // while statement
+        eat(TokenType::WHILE);
+        eat(TokenType::LEFT_PAREN);
+        if (failed)
+            return nullptr;
+
+        Ptr<Expr> condition = parseExpr();
+        if (failed)
+            return nullptr;
+
+        eat(TokenType::RIGHT_PAREN);
+        if (failed)
+            return nullptr;
+
+        Ptr<Stmt> body = parseStmt();
+        if (failed)
+            return nullptr;
+
+        return context.create<WhileStmt>(condition, body);
+    }
+
+    if (peek().type == TokenType::RETURN) {
+        // return statement
+        eat(TokenType::RETURN);
+
+        Ptr<Expr> value = nullptr;
+
+        if (peek().type != TokenType::SEMICOLON) {
+            value = parseExpr();
+            if (failed)
+                return nullptr;
+        }
+
+        eat(TokenType::SEMICOLON);
+        if (failed)
+            return nullptr;
+
+        return context.create<ReturnStmt>(value);
+    }
 
     // exprstmt
     Ptr<Expr> expr = parseExpr();
+    if (failed)
+        return nullptr;
+
     eat(TokenType::SEMICOLON);
+    if (failed)
+        return nullptr;
 
-    return make_shared<ExprStmt>(expr);
+    return context.create<ExprStmt>(expr);
 }
 
 // forinit = exprstmt | vardeclstmt | ";"
@@ -349,48 +675,75 @@ Ptr<Stmt> Parser::Implementation::parseForInit() {
         if (peek().type == TokenType::EQUALS) {
             eat(TokenType::EQUALS);
             init = parseExpr();
+            if (failed)
+                return nullptr;
         }
 
         eat(TokenType::SEMICOLON);
+        if (failed)
+            return nullptr;
 
-        return make_shared<VarDecl>(type, name, init);
+        return context.create<VarDecl>(type, name, init);
     }
 
     if (peek().type == TokenType::SEMICOLON) {
         // empty statement
         eat(TokenType::SEMICOLON);
-        return make_shared<EmptyStmt>();
+        return context.create<EmptyStmt>();
     }
 
     // exprstmt
     Ptr<Expr> expr = parseExpr();
+    if (failed)
+        return nullptr;
+
     eat(TokenType::SEMICOLON);
+    if (failed)
+        return nullptr;
 
-    return make_shared<ExprStmt>(expr);
+    return context.create<ExprStmt>(expr);
 }
 
 // compoundstmt = "{" stmt* "}"
 Ptr<CompoundStmt> Parser::Implementation::parseCompoundStmt() {
     LLVM_DEBUG(llvm::dbgs() << "In parseCompoundStmt()\n");
 
-    List<Ptr<Stmt>> body;
+    llvm::SmallVector<Ptr<Stmt>, 8> body;
     eat(TokenType::LEFT_BRACE);
+    if (failed)
+        return nullptr;
+
+    // A FuncDecl in a block means that its "}" is missing.
+    while (peek().type != TokenType::RIGHT_BRACE &&
+           peek().type != TokenType::END_OF_FILE && !isAtFuncDecl()) {
+        Ptr<Stmt> stmt = parseStmt();
 
-    while (peek().type != TokenType::RIGHT_BRACE) {
-        auto stmt = parseStmt();
-        if (stmt)
-            body.emplace_back(stmt);
+        if (failed) {
+            // Leave the rest of the FuncDecl to parseProgram().
+            if (skippingFuncDecl || !skipStatement()) {
+                skippingFuncDecl = true;
+                return nullptr;
+            }
+
+            failed = false;
+            continue;
+        }
+
+        body.emplace_back(stmt);
     }
 
     eat(TokenType::RIGHT_BRACE);
-    return make_shared<CompoundStmt>(body);
+    if (failed)
+        return nullptr;
+
+    return context.create<CompoundStmt>(context.createList<Ptr<Stmt>>(body));
 }
 
-// expr = atom
+// expr = assignment, see binaryOperators
 Ptr<Expr> Parser::Implementation::parseExpr() {
     LLVM_DEBUG(llvm::dbgs() << "In parseExpr()\n");
 
-    return parseAssignment();
+    return parseBinaryOpExpr(lowestPrecedence);
 }
 
 // atom = INTEGER | '(' expr ')'
@@ -406,7 +759,12 @@ Ptr<Expr> Parser::Implementation::parseAtom() {
         // parenthesised expression
         eat(TokenType::LEFT_PAREN);
         Ptr<Expr> expr = parseExpr();
+        if (failed)
+            return nullptr;
+
         eat(TokenType::RIGHT_PAREN);
+        if (failed)
+            return nullptr;
 
         return expr;
     }
@@ -431,8 +789,8 @@ Ptr<Expr> Parser::Implementation::parseAtom() {
         return parseVarRefExpr();
     }
 
-    throw error(fmt::format("Unexpected token type '{}' for atom",
-                            token_type_to_string(peek().type)));
+    return error(fmt::format("Unexpected token type '{}' for atom",
+                             token_type_to_string(peek().type)));
 }
 
 // intliteral = INTEGER
@@ -440,9 +798,10 @@ Ptr<IntLiteral> Parser::Implementation::parseIntLiteral() {
     LLVM_DEBUG(llvm::dbgs() << "In parseIntLiteral()\n");
 
     Token tok = eat(TokenType::INT_LITERAL);
-    int value = std::stoi(tok.lexeme);
+    if (failed)
+        return nullptr;
 
-    return make_shared<IntLiteral>(value);
+    return context.create<IntLiteral>(tok.intValue);
 }
 
 // ASSIGNMENT: Define additional parsing functions here.
@@ -450,27 +809,31 @@ Ptr<StringLiteral> Parser::Implementation::parseStringLiteral() {
     LLVM_DEBUG(llvm::dbgs() << "In parseStringLiteral()\n");
 
     Token tok = eat(TokenType::STRING_LITERAL);
-    std::string string = tok.lexeme;
-    std::string value = string.substr(1, string.size() - 2);
+    if (failed)
+        return nullptr;
+    std::string_view value = tok.lexeme.substr(1, tok.lexeme.size() - 2);
 
-    return make_shared<StringLiteral>(value);
+    return context.create<StringLiteral>(value);
 }
 
 Ptr<FloatLiteral> Parser::Implementation::parseFloatLiteral() {
     LLVM_DEBUG(llvm::dbgs() << "In parseFloatLiteral()\n");
 
     Token tok = eat(TokenType::FLOAT_LITERAL);
-    float value = std::stof(tok.lexeme);
+    if (failed)
+        return nullptr;
 
-    return make_shared<FloatLiteral>(value);
+    return context.create<FloatLiteral>(tok.floatValue);
 }
 
 Ptr<VarRefExpr> Parser::Implementation::parseVarRefExpr() {
     LLVM_DEBUG(llvm::dbgs() << "In parseVarRefExpr()\n");
 
     Token tok = eat(TokenType::IDENTIFIER);
+    if (failed)
+        return nullptr;
 
-    return make_shared<VarRefExpr>(tok);
+    return context.create<VarRefExpr>(tok);
 }
 
 Ptr<ArrayRefExpr> Parser::Implementation::parseArrayRefExpr() {
@@ -478,20 +841,33 @@ Ptr<ArrayRefExpr> Parser::Implementation::parseArrayRefExpr() {
 
     Token tok = eat(TokenType::IDENTIFIER);
     eat(TokenType::LEFT_BRACKET);
+    if (failed)
+        return nullptr;
+
     Ptr<Expr> index = parseExpr();
+    if (failed)
+        return nullptr;
+
     eat(TokenType::RIGHT_BRACKET);
+    if (failed)
+        return nullptr;
 
-    return make_shared<ArrayRefExpr>(tok, index);
+    return context.create<ArrayRefExpr>(tok, index);
 }
 
 Ptr<FuncCallExpr> Parser::Implementation::parseFuncCallExpr() {
     LLVM_DEBUG(llvm::dbgs() << "In parseFuncCallExpr()\n");
 
     Token functionName = eat(TokenType::IDENTIFIER);
-    List<Ptr<Expr>> arguments;
+    llvm::SmallVector<Ptr<Expr>, 4> arguments;
     eat(TokenType::LEFT_PAREN);
+    if (failed)
+        return nullptr;
+
     if (peek().type != TokenType::RIGHT_PAREN) {
         Ptr<Expr> arg = parseExpr();
+        if (failed)
+            return nullptr;
 
         arguments.emplace_back(arg);
 
@@ -500,89 +876,88 @@ Ptr<FuncCallExpr> Parser::Implementation::parseFuncCallExpr() {
             eat(TokenType::COMMA);
 
             Ptr<Expr> arg = parseExpr();
+            if (failed)
+                return nullptr;
 
             arguments.emplace_back(arg);
         }
     }
 
     eat(TokenType::RIGHT_PAREN);
+    if (failed)
+        return nullptr;
 
-    return make_shared<FuncCallExpr>(functionName, arguments);
-}
-
-Ptr<Expr> Parser::Implementation::parseCarret() {
-    LLVM_DEBUG(llvm::dbgs() << "In parseCarret()\n");
-
-    Ptr<Expr> lhs = parseAtom();
-    Token tok = peek();
-    if (tok.type == TokenType::CARET) {
-        eat(TokenType::CARET);
-        Ptr<Expr> rhs = parseCarret();
-        return make_shared<BinaryOpExpr>(lhs, tok, rhs);
-    }
-    return lhs;
+    return context.create<FuncCallExpr>(
+        functionName, context.createList<Ptr<Expr>>(arguments));
 }
 
-Ptr<Expr> Parser::Implementation::parseUnaryOpExpr() {
-    LLVM_DEBUG(llvm::dbgs() << "In parseUnaryOpExpr()\n");
+// expr = unaryexpr (BINARY_OPERATOR unaryexpr)*
+//
+// The binary operators are grouped by their precedence and associativity in
+// binaryOperators. Only the operators that bind at least as tight as
+// minPrecedence are parsed, so that the operands of an operator can be parsed
+// by a recursive call.
+Ptr<Expr> Parser::Implementation::parseBinaryOpExpr(unsigned minPrecedence) {
+    LLVM_DEBUG(llvm::dbgs() << "In parseBinaryOpExpr()\n");
+
+    if (isStackNearlyExhausted())
+        return runOnNewStack(
+            [this, minPrecedence] { return parseBinaryOpExpr(minPrecedence); });
+
+    Ptr<Expr> lhs = parseUnaryOpExpr(minPrecedence);
+    if (failed)
+        return nullptr;
 
-    Token op = peek();
+    // Precedence of the last non-associative operator that was parsed, so that
+    // e.g. a == b == c is rejected.
+    unsigned nonAssociative = 0;
 
-    if (op.type == TokenType::PLUS) {
-        eat(TokenType::PLUS);
-        Ptr<Expr> rhs = parseUnaryOpExpr();
-        return make_shared<UnaryOpExpr>(op, rhs);
-    } else if (op.type == TokenType::MINUS) {
-        eat(TokenType::MINUS);
-        Ptr<Expr> rhs = parseUnaryOpExpr();
-        return make_shared<UnaryOpExpr>(op, rhs);
-    }
+    while (true) {
+        TokenType type = peek().type;
+        BinaryOperator op = getBinaryOperator(type);
 
-    return parseCarret();
-}
+        if (op.precedence < minPrecedence)
+            return lhs;
 
-Ptr<Expr> Parser::Implementation::parseMultiplicative() {
-    LLVM_DEBUG(llvm::dbgs() << "In parseMultiplivative()\n");
+        if (op.precedence == nonAssociative)
+            return error("non-associative operators may not be used "
+                         "multiple times in a row");
 
-    Ptr<Expr> lhs = parseUnaryOpExpr();
+        Token token = eat(type);
 
-    Token tok = eat(peek().type);
+        // The right operand of a left-associative (or non-associative)
+        // operator may only contain operators that bind tighter.
+        Ptr<Expr> rhs = parseBinaryOpExpr(
+            op.associativity == Associativity::Right ? op.precedence
+                                                     : op.precedence + 1);
+        if (failed)
+            return nullptr;
 
-    while (tok.type == TokenType::STAR || tok.type == TokenType::SLASH ||
-           tok.type == TokenType::PERCENT) {
+        lhs = context.create<BinaryOpExpr>(lhs, token, rhs);
 
-        Ptr<Expr> rhs = parseUnaryOpExpr();
-        lhs = make_shared<BinaryOpExpr>(lhs, tok, rhs);
+        if (op.associativity == Associativity::None)
+            nonAssociative = op.precedence;
     }
 }
 
-Ptr<Expr> Parser::Implementation::parseAdditive() {
-    LLVM_DEBUG(llvm::dbgs() << "In parseAdditive()\n");
+// unaryexpr = ("+" | "-") unaryexpr ("^" ...)* | atom
+//
+// Like in the grammar, the operands of operators that bind tighter than the
+// unary operators (i.e. ^) cannot start with one.
+Ptr<Expr> Parser::Implementation::parseUnaryOpExpr(unsigned minPrecedence) {
+    LLVM_DEBUG(llvm::dbgs() << "In parseUnaryOpExpr()\n");
 
-    Ptr<Expr> lhs = parseMultiplicative();
-    while (peek().type == TokenType::PLUS || peek().type == TokenType::MINUS) {
-        Token tok = peek();
+    TokenType type = peek().type;
 
-        if (tok.type == TokenType::PLUS) {
-            eat(TokenType::PLUS);
-        } else if (tok.type == TokenType::MINUS) {
-            eat(TokenType::MINUS);
-        }
+    if ((type == TokenType::PLUS || type == TokenType::MINUS) &&
+        minPrecedence <= unaryPrecedence) {
+        Token op = eat(type);
+        Ptr<Expr> operand = parseBinaryOpExpr(unaryPrecedence);
+        if (failed)
+            return nullptr;
 
-        Ptr<Expr> operand = parseMultiplicative();
-        lhs = make_shared<BinaryOpExpr>(lhs, tok, operand);
+        return context.create<UnaryOpExpr>(op, operand);
     }
-    return lhs;
-}
-
-Ptr<Expr> Parser::Implementation::parseComparison() {
-    LLVM_DEBUG(llvm::dbgs() << "In parseComparison()\n");
-}
 
-Ptr<Expr> Parser::Implementation::parseEquality() {
-    LLVM_DEBUG(llvm::dbgs() << "In parseEquality()\n");
+    return parseAtom();
 }
-
-Ptr<Expr> Parser::Implementation::parseAssignment() {
-    LLVM_DEBUG(llvm::dbgs() << "In parseAssignment()\n");
-}
\ No newline at end of file
@@ -2,27 +2,25 @@
 #define PARSER_HPP
 
 #include "ast/ast.hpp"
+#include "ast/astcontext.hpp"
+#include "lexer/diagnosticengine.hpp"
 #include "lexer/token.hpp"
+#include "lexer/tokensource.hpp"
 
 #include <memory>
-#include <stdexcept>
-#include <string>
-#include <vector>
 
 class Parser {
 public:
-  Parser(const std::vector<Token> &tokens);
+  // The parser pulls tokens from the source (e.g. a Lexer) as it needs them,
+  // so the source must outlive the parser. Errors are reported to
+  // diagnostics as they occur, and parsing stops at its error limit. The
+  // nodes of the AST are allocated in context.
+  Parser(TokenSource &tokens, DiagnosticEngine &diagnostics,
+         ast::ASTContext &context);
   ~Parser();
   ast::Ptr<ast::Base> parse();
   bool hadError() const;
 
-  struct ParserException : public std::runtime_error {
-    Token token;
-
-    ParserException(const Token &token, const std::string &message)
-        : std::runtime_error(message), token(token) {}
-  };
-
 private:
   struct Implementation;
   std::unique_ptr<Implementation> pImpl;
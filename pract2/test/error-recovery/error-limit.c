@@ -0,0 +1,19 @@
+// RUN-WITH-ARGS: -ferror-limit=1
+// Parsing stops at the error limit, before the lexer reaches the "@".
+int first()
+{
+    int x = ;
+    x = 1 +;
+    while (x {
+        x = x - 1;
+    }
+}
+
+int second( {
+    return 0;
+}
+
+int third()
+{
+    return @;
+}
@@ -0,0 +1,18 @@
+int missing_argument(int x,)
+{
+    x;
+}
+
+int missing_brace()
+{
+    x;
+
+int after_missing_brace()
+{
+    int y z;
+}
+
+int correct()
+{
+    return 0;
+}
@@ -0,0 +1,13 @@
+int statements()
+{
+    int x = ;
+    x = 1 +;
+
+    while (x) {
+        x = = 2;
+    }
+
+    if (x { x; }
+
+    return x;
+}
@@ -0,0 +1,6 @@
+int complete()
+{
+    return 0;
+}
+
+int truncated() { return 1
\ No newline at end of file
@@ -0,0 +1,709 @@
+// RUN-WITH-ARGS: -lexer-thread -ferror-limit=2 -fsyntax-only
+// More tokens than fit in the queue of the lexer thread, followed by more
+// lexer errors than the limit allows.
+int f0() { return 0; }
+int f1() { return 1; }
+int f2() { return 2; }
+int f3() { return 3; }
+int f4() { return 4; }
+int f5() { return 5; }
+int f6() { return 6; }
+int f7() { return 7; }
+int f8() { return 8; }
+int f9() { return 9; }
+int f10() { return 10; }
+int f11() { return 11; }
+int f12() { return 12; }
+int f13() { return 13; }
+int f14() { return 14; }
+int f15() { return 15; }
+int f16() { return 16; }
+int f17() { return 17; }
+int f18() { return 18; }
+int f19() { return 19; }
+int f20() { return 20; }
+int f21() { return 21; }
+int f22() { return 22; }
+int f23() { return 23; }
+int f24() { return 24; }
+int f25() { return 25; }
+int f26() { return 26; }
+int f27() { return 27; }
+int f28() { return 28; }
+int f29() { return 29; }
+int f30() { return 30; }
+int f31() { return 31; }
+int f32() { return 32; }
+int f33() { return 33; }
+int f34() { return 34; }
+int f35() { return 35; }
+int f36() { return 36; }
+int f37() { return 37; }
+int f38() { return 38; }
+int f39() { return 39; }
+int f40() { return 40; }
+int f41() { return 41; }
+int f42() { return 42; }
+int f43() { return 43; }
+int f44() { return 44; }
+int f45() { return 45; }
+int f46() { return 46; }
+int f47() { return 47; }
+int f48() { return 48; }
+int f49() { return 49; }
+int f50() { return 50; }
+int f51() { return 51; }
+int f52() { return 52; }
+int f53() { return 53; }
+int f54() { return 54; }
+int f55() { return 55; }
+int f56() { return 56; }
+int f57() { return 57; }
+int f58() { return 58; }
+int f59() { return 59; }
+int f60() { return 60; }
+int f61() { return 61; }
+int f62() { return 62; }
+int f63() { return 63; }
+int f64() { return 64; }
+int f65() { return 65; }
+int f66() { return 66; }
+int f67() { return 67; }
+int f68() { return 68; }
+int f69() { return 69; }
+int f70() { return 70; }
+int f71() { return 71; }
+int f72() { return 72; }
+int f73() { return 73; }
+int f74() { return 74; }
+int f75() { return 75; }
+int f76() { return 76; }
+int f77() { return 77; }
+int f78() { return 78; }
+int f79() { return 79; }
+int f80() { return 80; }
+int f81() { return 81; }
+int f82() { return 82; }
+int f83() { return 83; }
+int f84() { return 84; }
+int f85() { return 85; }
+int f86() { return 86; }
+int f87() { return 87; }
+int f88() { return 88; }
+int f89() { return 89; }
+int f90() { return 90; }
+int f91() { return 91; }
+int f92() { return 92; }
+int f93() { return 93; }
+int f94() { return 94; }
+int f95() { return 95; }
+int f96() { return 96; }
+int f97() { return 97; }
+int f98() { return 98; }
+int f99() { return 99; }
+int f100() { return 100; }
+int f101() { return 101; }
+int f102() { return 102; }
+int f103() { return 103; }
+int f104() { return 104; }
+int f105() { return 105; }
+int f106() { return 106; }
+int f107() { return 107; }
+int f108() { return 108; }
+int f109() { return 109; }
+int f110() { return 110; }
+int f111() { return 111; }
+int f112() { return 112; }
+int f113() { return 113; }
+int f114() { return 114; }
+int f115() { return 115; }
+int f116() { return 116; }
+int f117() { return 117; }
+int f118() { return 118; }
+int f119() { return 119; }
+int f120() { return 120; }
+int f121() { return 121; }
+int f122() { return 122; }
+int f123() { return 123; }
+int f124() { return 124; }
+int f125() { return 125; }
+int f126() { return 126; }
+int f127() { return 127; }
+int f128() { return 128; }
+int f129() { return 129; }
+int f130() { return 130; }
+int f131() { return 131; }
+int f132() { return 132; }
+int f133() { return 133; }
+int f134() { return 134; }
+int f135() { return 135; }
+int f136() { return 136; }
+int f137() { return 137; }
+int f138() { return 138; }
+int f139() { return 139; }
+int f140() { return 140; }
+int f141() { return 141; }
+int f142() { return 142; }
+int f143() { return 143; }
+int f144() { return 144; }
+int f145() { return 145; }
+int f146() { return 146; }
+int f147() { return 147; }
+int f148() { return 148; }
+int f149() { return 149; }
+int f150() { return 150; }
+int f151() { return 151; }
+int f152() { return 152; }
+int f153() { return 153; }
+int f154() { return 154; }
+int f155() { return 155; }
+int f156() { return 156; }
+int f157() { return 157; }
+int f158() { return 158; }
+int f159() { return 159; }
+int f160() { return 160; }
+int f161() { return 161; }
+int f162() { return 162; }
+int f163() { return 163; }
+int f164() { return 164; }
+int f165() { return 165; }
+int f166() { return 166; }
+int f167() { return 167; }
+int f168() { return 168; }
+int f169() { return 169; }
+int f170() { return 170; }
+int f171() { return 171; }
+int f172() { return 172; }
+int f173() { return 173; }
+int f174() { return 174; }
+int f175() { return 175; }
+int f176() { return 176; }
+int f177() { return 177; }
+int f178() { return 178; }
+int f179() { return 179; }
+int f180() { return 180; }
+int f181() { return 181; }
+int f182() { return 182; }
+int f183() { return 183; }
+int f184() { return 184; }
+int f185() { return 185; }
+int f186() { return 186; }
+int f187() { return 187; }
+int f188() { return 188; }
+int f189() { return 189; }
+int f190() { return 190; }
+int f191() { return 191; }
+int f192() { return 192; }
+int f193() { return 193; }
+int f194() { return 194; }
+int f195() { return 195; }
+int f196() { return 196; }
+int f197() { return 197; }
+int f198() { return 198; }
+int f199() { return 199; }
+int f200() { return 200; }
+int f201() { return 201; }
+int f202() { return 202; }
+int f203() { return 203; }
+int f204() { return 204; }
+int f205() { return 205; }
+int f206() { return 206; }
+int f207() { return 207; }
+int f208() { return 208; }
+int f209() { return 209; }
+int f210() { return 210; }
+int f211() { return 211; }
+int f212() { return 212; }
+int f213() { return 213; }
+int f214() { return 214; }
+int f215() { return 215; }
+int f216() { return 216; }
+int f217() { return 217; }
+int f218() { return 218; }
+int f219() { return 219; }
+int f220() { return 220; }
+int f221() { return 221; }
+int f222() { return 222; }
+int f223() { return 223; }
+int f224() { return 224; }
+int f225() { return 225; }
+int f226() { return 226; }
+int f227() { return 227; }
+int f228() { return 228; }
+int f229() { return 229; }
+int f230() { return 230; }
+int f231() { return 231; }
+int f232() { return 232; }
+int f233() { return 233; }
+int f234() { return 234; }
+int f235() { return 235; }
+int f236() { return 236; }
+int f237() { return 237; }
+int f238() { return 238; }
+int f239() { return 239; }
+int f240() { return 240; }
+int f241() { return 241; }
+int f242() { return 242; }
+int f243() { return 243; }
+int f244() { return 244; }
+int f245() { return 245; }
+int f246() { return 246; }
+int f247() { return 247; }
+int f248() { return 248; }
+int f249() { return 249; }
+int f250() { return 250; }
+int f251() { return 251; }
+int f252() { return 252; }
+int f253() { return 253; }
+int f254() { return 254; }
+int f255() { return 255; }
+int f256() { return 256; }
+int f257() { return 257; }
+int f258() { return 258; }
+int f259() { return 259; }
+int f260() { return 260; }
+int f261() { return 261; }
+int f262() { return 262; }
+int f263() { return 263; }
+int f264() { return 264; }
+int f265() { return 265; }
+int f266() { return 266; }
+int f267() { return 267; }
+int f268() { return 268; }
+int f269() { return 269; }
+int f270() { return 270; }
+int f271() { return 271; }
+int f272() { return 272; }
+int f273() { return 273; }
+int f274() { return 274; }
+int f275() { return 275; }
+int f276() { return 276; }
+int f277() { return 277; }
+int f278() { return 278; }
+int f279() { return 279; }
+int f280() { return 280; }
+int f281() { return 281; }
+int f282() { return 282; }
+int f283() { return 283; }
+int f284() { return 284; }
+int f285() { return 285; }
+int f286() { return 286; }
+int f287() { return 287; }
+int f288() { return 288; }
+int f289() { return 289; }
+int f290() { return 290; }
+int f291() { return 291; }
+int f292() { return 292; }
+int f293() { return 293; }
+int f294() { return 294; }
+int f295() { return 295; }
+int f296() { return 296; }
+int f297() { return 297; }
+int f298() { return 298; }
+int f299() { return 299; }
+int f300() { return 300; }
+int f301() { return 301; }
+int f302() { return 302; }
+int f303() { return 303; }
+int f304() { return 304; }
+int f305() { return 305; }
+int f306() { return 306; }
+int f307() { return 307; }
+int f308() { return 308; }
+int f309() { return 309; }
+int f310() { return 310; }
+int f311() { return 311; }
+int f312() { return 312; }
+int f313() { return 313; }
+int f314() { return 314; }
+int f315() { return 315; }
+int f316() { return 316; }
+int f317() { return 317; }
+int f318() { return 318; }
+int f319() { return 319; }
+int f320() { return 320; }
+int f321() { return 321; }
+int f322() { return 322; }
+int f323() { return 323; }
+int f324() { return 324; }
+int f325() { return 325; }
+int f326() { return 326; }
+int f327() { return 327; }
+int f328() { return 328; }
+int f329() { return 329; }
+int f330() { return 330; }
+int f331() { return 331; }
+int f332() { return 332; }
+int f333() { return 333; }
+int f334() { return 334; }
+int f335() { return 335; }
+int f336() { return 336; }
+int f337() { return 337; }
+int f338() { return 338; }
+int f339() { return 339; }
+int f340() { return 340; }
+int f341() { return 341; }
+int f342() { return 342; }
+int f343() { return 343; }
+int f344() { return 344; }
+int f345() { return 345; }
+int f346() { return 346; }
+int f347() { return 347; }
+int f348() { return 348; }
+int f349() { return 349; }
+int f350() { return 350; }
+int f351() { return 351; }
+int f352() { return 352; }
+int f353() { return 353; }
+int f354() { return 354; }
+int f355() { return 355; }
+int f356() { return 356; }
+int f357() { return 357; }
+int f358() { return 358; }
+int f359() { return 359; }
+int f360() { return 360; }
+int f361() { return 361; }
+int f362() { return 362; }
+int f363() { return 363; }
+int f364() { return 364; }
+int f365() { return 365; }
+int f366() { return 366; }
+int f367() { return 367; }
+int f368() { return 368; }
+int f369() { return 369; }
+int f370() { return 370; }
+int f371() { return 371; }
+int f372() { return 372; }
+int f373() { return 373; }
+int f374() { return 374; }
+int f375() { return 375; }
+int f376() { return 376; }
+int f377() { return 377; }
+int f378() { return 378; }
+int f379() { return 379; }
+int f380() { return 380; }
+int f381() { return 381; }
+int f382() { return 382; }
+int f383() { return 383; }
+int f384() { return 384; }
+int f385() { return 385; }
+int f386() { return 386; }
+int f387() { return 387; }
+int f388() { return 388; }
+int f389() { return 389; }
+int f390() { return 390; }
+int f391() { return 391; }
+int f392() { return 392; }
+int f393() { return 393; }
+int f394() { return 394; }
+int f395() { return 395; }
+int f396() { return 396; }
+int f397() { return 397; }
+int f398() { return 398; }
+int f399() { return 399; }
+int f400() { return 400; }
+int f401() { return 401; }
+int f402() { return 402; }
+int f403() { return 403; }
+int f404() { return 404; }
+int f405() { return 405; }
+int f406() { return 406; }
+int f407() { return 407; }
+int f408() { return 408; }
+int f409() { return 409; }
+int f410() { return 410; }
+int f411() { return 411; }
+int f412() { return 412; }
+int f413() { return 413; }
+int f414() { return 414; }
+int f415() { return 415; }
+int f416() { return 416; }
+int f417() { return 417; }
+int f418() { return 418; }
+int f419() { return 419; }
+int f420() { return 420; }
+int f421() { return 421; }
+int f422() { return 422; }
+int f423() { return 423; }
+int f424() { return 424; }
+int f425() { return 425; }
+int f426() { return 426; }
+int f427() { return 427; }
+int f428() { return 428; }
+int f429() { return 429; }
+int f430() { return 430; }
+int f431() { return 431; }
+int f432() { return 432; }
+int f433() { return 433; }
+int f434() { return 434; }
+int f435() { return 435; }
+int f436() { return 436; }
+int f437() { return 437; }
+int f438() { return 438; }
+int f439() { return 439; }
+int f440() { return 440; }
+int f441() { return 441; }
+int f442() { return 442; }
+int f443() { return 443; }
+int f444() { return 444; }
+int f445() { return 445; }
+int f446() { return 446; }
+int f447() { return 447; }
+int f448() { return 448; }
+int f449() { return 449; }
+int f450() { return 450; }
+int f451() { return 451; }
+int f452() { return 452; }
+int f453() { return 453; }
+int f454() { return 454; }
+int f455() { return 455; }
+int f456() { return 456; }
+int f457() { return 457; }
+int f458() { return 458; }
+int f459() { return 459; }
+int f460() { return 460; }
+int f461() { return 461; }
+int f462() { return 462; }
+int f463() { return 463; }
+int f464() { return 464; }
+int f465() { return 465; }
+int f466() { return 466; }
+int f467() { return 467; }
+int f468() { return 468; }
+int f469() { return 469; }
+int f470() { return 470; }
+int f471() { return 471; }
+int f472() { return 472; }
+int f473() { return 473; }
+int f474() { return 474; }
+int f475() { return 475; }
+int f476() { return 476; }
+int f477() { return 477; }
+int f478() { return 478; }
+int f479() { return 479; }
+int f480() { return 480; }
+int f481() { return 481; }
+int f482() { return 482; }
+int f483() { return 483; }
+int f484() { return 484; }
+int f485() { return 485; }
+int f486() { return 486; }
+int f487() { return 487; }
+int f488() { return 488; }
+int f489() { return 489; }
+int f490() { return 490; }
+int f491() { return 491; }
+int f492() { return 492; }
+int f493() { return 493; }
+int f494() { return 494; }
+int f495() { return 495; }
+int f496() { return 496; }
+int f497() { return 497; }
+int f498() { return 498; }
+int f499() { return 499; }
+int f500() { return 500; }
+int f501() { return 501; }
+int f502() { return 502; }
+int f503() { return 503; }
+int f504() { return 504; }
+int f505() { return 505; }
+int f506() { return 506; }
+int f507() { return 507; }
+int f508() { return 508; }
+int f509() { return 509; }
+int f510() { return 510; }
+int f511() { return 511; }
+int f512() { return 512; }
+int f513() { return 513; }
+int f514() { return 514; }
+int f515() { return 515; }
+int f516() { return 516; }
+int f517() { return 517; }
+int f518() { return 518; }
+int f519() { return 519; }
+int f520() { return 520; }
+int f521() { return 521; }
+int f522() { return 522; }
+int f523() { return 523; }
+int f524() { return 524; }
+int f525() { return 525; }
+int f526() { return 526; }
+int f527() { return 527; }
+int f528() { return 528; }
+int f529() { return 529; }
+int f530() { return 530; }
+int f531() { return 531; }
+int f532() { return 532; }
+int f533() { return 533; }
+int f534() { return 534; }
+int f535() { return 535; }
+int f536() { return 536; }
+int f537() { return 537; }
+int f538() { return 538; }
+int f539() { return 539; }
+int f540() { return 540; }
+int f541() { return 541; }
+int f542() { return 542; }
+int f543() { return 543; }
+int f544() { return 544; }
+int f545() { return 545; }
+int f546() { return 546; }
+int f547() { return 547; }
+int f548() { return 548; }
+int f549() { return 549; }
+int f550() { return 550; }
+int f551() { return 551; }
+int f552() { return 552; }
+int f553() { return 553; }
+int f554() { return 554; }
+int f555() { return 555; }
+int f556() { return 556; }
+int f557() { return 557; }
+int f558() { return 558; }
+int f559() { return 559; }
+int f560() { return 560; }
+int f561() { return 561; }
+int f562() { return 562; }
+int f563() { return 563; }
+int f564() { return 564; }
+int f565() { return 565; }
+int f566() { return 566; }
+int f567() { return 567; }
+int f568() { return 568; }
+int f569() { return 569; }
+int f570() { return 570; }
+int f571() { return 571; }
+int f572() { return 572; }
+int f573() { return 573; }
+int f574() { return 574; }
+int f575() { return 575; }
+int f576() { return 576; }
+int f577() { return 577; }
+int f578() { return 578; }
+int f579() { return 579; }
+int f580() { return 580; }
+int f581() { return 581; }
+int f582() { return 582; }
+int f583() { return 583; }
+int f584() { return 584; }
+int f585() { return 585; }
+int f586() { return 586; }
+int f587() { return 587; }
+int f588() { return 588; }
+int f589() { return 589; }
+int f590() { return 590; }
+int f591() { return 591; }
+int f592() { return 592; }
+int f593() { return 593; }
+int f594() { return 594; }
+int f595() { return 595; }
+int f596() { return 596; }
+int f597() { return 597; }
+int f598() { return 598; }
+int f599() { return 599; }
+int f600() { return 600; }
+int f601() { return 601; }
+int f602() { return 602; }
+int f603() { return 603; }
+int f604() { return 604; }
+int f605() { return 605; }
+int f606() { return 606; }
+int f607() { return 607; }
+int f608() { return 608; }
+int f609() { return 609; }
+int f610() { return 610; }
+int f611() { return 611; }
+int f612() { return 612; }
+int f613() { return 613; }
+int f614() { return 614; }
+int f615() { return 615; }
+int f616() { return 616; }
+int f617() { return 617; }
+int f618() { return 618; }
+int f619() { return 619; }
+int f620() { return 620; }
+int f621() { return 621; }
+int f622() { return 622; }
+int f623() { return 623; }
+int f624() { return 624; }
+int f625() { return 625; }
+int f626() { return 626; }
+int f627() { return 627; }
+int f628() { return 628; }
+int f629() { return 629; }
+int f630() { return 630; }
+int f631() { return 631; }
+int f632() { return 632; }
+int f633() { return 633; }
+int f634() { return 634; }
+int f635() { return 635; }
+int f636() { return 636; }
+int f637() { return 637; }
+int f638() { return 638; }
+int f639() { return 639; }
+int f640() { return 640; }
+int f641() { return 641; }
+int f642() { return 642; }
+int f643() { return 643; }
+int f644() { return 644; }
+int f645() { return 645; }
+int f646() { return 646; }
+int f647() { return 647; }
+int f648() { return 648; }
+int f649() { return 649; }
+int f650() { return 650; }
+int f651() { return 651; }
+int f652() { return 652; }
+int f653() { return 653; }
+int f654() { return 654; }
+int f655() { return 655; }
+int f656() { return 656; }
+int f657() { return 657; }
+int f658() { return 658; }
+int f659() { return 659; }
+int f660() { return 660; }
+int f661() { return 661; }
+int f662() { return 662; }
+int f663() { return 663; }
+int f664() { return 664; }
+int f665() { return 665; }
+int f666() { return 666; }
+int f667() { return 667; }
+int f668() { return 668; }
+int f669() { return 669; }
+int f670() { return 670; }
+int f671() { return 671; }
+int f672() { return 672; }
+int f673() { return 673; }
+int f674() { return 674; }
+int f675() { return 675; }
+int f676() { return 676; }
+int f677() { return 677; }
+int f678() { return 678; }
+int f679() { return 679; }
+int f680() { return 680; }
+int f681() { return 681; }
+int f682() { return 682; }
+int f683() { return 683; }
+int f684() { return 684; }
+int f685() { return 685; }
+int f686() { return 686; }
+int f687() { return 687; }
+int f688() { return 688; }
+int f689() { return 689; }
+int f690() { return 690; }
+int f691() { return 691; }
+int f692() { return 692; }
+int f693() { return 693; }
+int f694() { return 694; }
+int f695() { return 695; }
+int f696() { return 696; }
+int f697() { return 697; }
+int f698() { return 698; }
+int f699() { return 699; }
+int g()
+{
+    int a = @;
+    int b = 1.2.3;
+    int c = #;
+}
@@ -0,0 +1,19 @@
+// RUN-WITH-ARGS: -lexer-thread
+int fib(int n)
+{
+    if (n < 2)
+        return n;
+    return fib(n - 1) + fib(n - 2);
+}
+
+int main()
+{
+    int values[10];
+    int i = 0;
+    while (i < 10) {
+        values[i] = fib(i);
+        i = i + 1;
+    }
+    print("done");
+    return values[9];
+}
@@ -0,0 +1,15 @@
+// RUN-WITH-ARGS: -j=3 -parse-chunk-size=1
+int first()
+{
+    return 1 +;
+}
+
+int second()
+{
+    x = ;
+}
+
+int third()
+{
+    return 3;
+}
@@ -0,0 +1,21 @@
+// RUN-WITH-ARGS: -j=3 -parse-chunk-size=1 -dump-ids
+int first(int a)
+{
+    if (a) { return a; } else { return 0; }
+}
+
+int second()
+{
+    for (int i = 0; i < 10; i = i + 1) {
+        first(i);
+    }
+}
+
+int third()
+{
+    {
+        {
+            return -2 ^ 3;
+        }
+    }
+}
@@ -0,0 +1,20 @@
+// A token file written by the lexer gives the same AST as the source itself.
+// Regenerate round-trip.custom.c.mctok with "microcc -emit-tokens" of pract1
+// when this file changes.
+// RUN: %diff-command-output.sh %s %t -- %microcc %s
+// RUN: %diff-command-output.sh %s %t -- %microcc %s.mctok
+int sum(int n)
+{
+    int total = 0;
+    while (n > 0) {
+        total = total + n;
+        n = n - 1;
+    }
+    return total;
+}
+
+float scale(float x)
+{
+    char name[8];
+    return x * 2.5;
+}